@@ -5,45 +5,30 @@
 #include <cmath>
 #include <thread>
 #include <future>
+#include <span>
+#include "work-stealing.h"
+#include "result-sink.h"
+#include "power.h"
+#include "philox.h"
+#include "topology.h"
+#include "product.h"
 
 using Real = double ;
 using Complex = std::complex<Real> ;
 using Complexes = std::vector<Complex> ;
 
-// random unitary complexes
-void generate( Complexes & cs )
- {
-  srand(1) ;
-  for ( auto & c : cs )
-   { 
-    Real angle {rand()/(Real(RAND_MAX)+1)*2.0*M_PI} ;
-    c = Complex{std::cos(angle),std::sin(angle)} ;
-   }
- }
+// random unitary complexes : the numbers [first,first+cs.size())
+// of a single sequence, so that any thread can generate any slice
+void generate( std::span<Complex> cs, std::size_t first = 0 )
+ { philox::Philox{1}.unit_complexes(cs,first) ; }
 
-// compute a slice of xs^degree and return it
-Complexes complexes_pow
- ( std::size_t num_slice, std::size_t nb_slices,
-   Complexes const & xs, int degree )
- {
-  assert((xs.size()%nb_slices)==0) ;  
-  auto slice_size {xs.size()/nb_slices} ;
-  auto min {num_slice*slice_size} ;
-  Complexes ys(slice_size) ;
-  for ( decltype(slice_size) i {0} ; i<slice_size ; ++i )
-   {
-    ys[i] = Complex{1.,0.} ;
-    for ( int d=0 ; d<degree ; ++d )
-     { ys[i] *= xs[i+min] ; }
-   }
-  return ys ;
- }
+// compute xs^degree and store it into ys, of same size
+void complexes_pow( std::span<Complex const> xs, power::Algorithm algorithm, int degree, std::span<Complex> ys )
+ { power::raise(algorithm,xs.size(),xs.data(),degree,ys.data()) ; }
 
 // display the angle of the global product
-void postprocess( Complexes const & cs )
+void postprocess( Complex prod )
  {
-  Complex prod {1.,0.} ;
-  for( auto c : cs ) { prod *= c ; }
   double angle {atan2(prod.imag(),prod.real())} ;
   std::cout<<"result = "<<static_cast<int>(angle/2./M_PI*360.)<<"\n" ;
  }
@@ -51,26 +36,48 @@ void postprocess( Complexes const & cs )
 // main program
 int main ( int argc, char * argv[] )
  {
-  assert(argc==4) ;
+  assert((argc>=4)&&(argc<=6)) ;
   std::size_t nbtasks {std::stoul(argv[1])} ;
   std::size_t dim {std::stoul(argv[2])} ;
   int degree {std::stoi(argv[3])} ;
+  Pinning pinning {select_pinning((argc>4)?argv[4]:"none")} ;
+  power::Algorithm algorithm {power::select_algorithm((argc>5)?argv[5]:"squaring")} ;
 
-  // prepare input
+  // prepare input and compute : the tasks share the pool threads, generate
+  // their slice of the input, and write their slice of the output directly
+  // into the final buffer, so more tasks only means finer chunks ; all
+  // the work is done within fill, so that any exception reaches when_any
   Complexes input(dim) ;
-  generate(input) ;
-   
-  // compute
-  std::vector<std::future<Complexes>> results ;
+  ResultSink<Complex> output(dim,nbtasks) ;
+  Topology topology ;
+  std::vector<unsigned> cpus {topology.placement(pinning,std::thread::hardware_concurrency())} ;
+  if (!cpus.empty()) topology.report(std::cerr) ;
+  WorkStealingPool pool(std::thread::hardware_concurrency(),[&]( std::size_t num )
+   { if (!cpus.empty()) pin_current(cpus[num]) ; }) ;
   for ( std::size_t numtask {0} ; numtask<nbtasks ; ++numtask )
-   { results.push_back(std::async(complexes_pow,numtask,nbtasks,input,degree)) ; }
-  Complexes output ;
-  for ( auto & futur_result_slice : results )
    {
-    Complexes result_slice = futur_result_slice.get() ;
-    output.insert(output.end(),result_slice.begin(),result_slice.end()) ;
+    pool.submit([&,numtask]
+     {
+      output.fill(numtask,[&]( std::span<Complex> ys )
+       {
+        std::size_t begin {output.range(numtask).first} ;
+        std::span<Complex> xs {input.data()+begin,ys.size()} ;
+        generate(xs,begin) ;
+        complexes_pow(xs,algorithm,degree,ys) ;
+       }) ;
+     }) ;
+   }
+
+  // the leaves of the product are computed as soon as their slices are
+  // completed, but combined along a fixed tree, so that the final result
+  // depends neither on the completion order, nor on the number of tasks
+  product::Cartesian<Real> prod {output.data()} ;
+  for ( std::size_t n {0} ; n<nbtasks ; ++n )
+   {
+    auto [begin,end] = output.range(output.when_any()) ;
+    prod.complete(begin,end) ;
    }
   
   // post-process
-  postprocess(output) ;
+  postprocess(prod.result()) ;
  }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <vector>
+#include <iostream>
+#include <cassert>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "execution.h"
+#include "philox.h"
+
+using Real = double ;
+using Reals = std::vector<Real> ;
+
+// random numbers in [1.-1./scal,1.], each chunk being generated
+// independently, but with the same values as a serial run
+template< typename Policy >
+void generate( Policy policy, Reals & rs, Real scale )
+ {
+  execution::for_tasks(policy,execution::nb_chunks(rs.size()),[&]( std::size_t num )
+   {
+    auto [begin,end] = execution::chunk(num,rs.size()) ;
+    philox::Philox{1}.uniform(std::span<Real>{rs.data()+begin,end-begin},begin) ;
+   }) ;
+  execution::transform(policy,rs.begin(),rs.end(),rs.begin(),[scale]( Real u ){ return 1.-u/scale ; }) ;
+ }
+
+// compute xs^degree and store it into ys
+template< typename Policy >
+void pow( Policy policy, Reals const & xs, int degree, Reals & ys )
+ {
+  execution::transform(policy,xs.begin(),xs.end(),ys.begin(),[degree]( Real x )
+   {
+    Real y {1.0} ;
+    for ( int d=0 ; d<degree ; ++d )
+     { y *= x ; }
+    return y ;
+   }) ;
+ }
+
+// compute the mean
+template< typename Policy >
+void postprocess( Policy policy, Reals const & rs )
+ { std::cout<<"mean: "<<(execution::reduce(policy,rs.begin(),rs.end(),Real{0.})/rs.size())<<"\n" ; }
+
+template< typename Policy >
+void process( Policy policy, std::size_t dim, int degree )
+ {
+  // prepare input
+  Reals input(dim) ;
+  generate(policy,input,degree) ;
+
+  // compute ouput
+  Reals output(dim) ;
+  pow(policy,input,degree,output) ;
+
+  // post-process
+  postprocess(policy,output) ;
+ }
+
+// main program : the optional number of threads
+// replaces the default one per core
+int main ( int argc, char * argv[] )
+ {
+  assert((argc>=3)&&(argc<=5)) ;
+  std::size_t dim {std::stoul(argv[1])} ;
+  int degree {std::stoi(argv[2])} ;
+  std::string_view policy {(argc>3)?argv[3]:"par"} ;
+  std::optional<WorkStealingPool> pool ;
+  if (argc>4) pool.emplace(std::stoul(argv[4])) ;
+  auto on_pool = [&]( auto parallel ){ return pool?parallel.on(*pool):parallel ; } ;
+
+  if (policy=="seq") process(execution::seq,dim,degree) ;
+  else if (policy=="unseq") process(execution::unseq,dim,degree) ;
+  else if (policy=="par") process(on_pool(execution::par),dim,degree) ;
+  else if (policy=="par_unseq") process(on_pool(execution::par_unseq),dim,degree) ;
+  else throw std::runtime_error("unknown policy: "+std::string(policy)) ;
+ }
@@ -0,0 +1,252 @@
+#ifndef EXECUTION_H
+#define EXECUTION_H
+
+#include "partitioner.h"
+#include "work-stealing.h"
+#include <algorithm> // for std::min, std::sort & std::inplace_merge
+#include <array>
+#include <cstddef> // for std::size_t
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::plus, std::less & std::identity
+#include <future>
+#include <iterator> // for std::random_access_iterator
+#include <type_traits> // for std::is_default_constructible_v
+#include <utility> // for std::pair
+#include <vector>
+
+// Parallel algorithms which do not depend on TBB, with policies
+// mirroring the ones of std::execution :
+// - par and par_unseq cut the elements into chunks of a fixed size,
+//   which are distributed among the threads of a WorkStealingPool ;
+// - unseq and par_unseq tell the compiler that the iterations of the
+//   loops over a chunk are independent, and split the reductions into
+//   several lanes, so that they can be vectorized.
+// The chunks do not depend on the number of threads, neither do the
+// results of reduce(), transform_reduce() and inclusive_scan().
+//
+// An algorithm called from a worker of the pool, for example by a task
+// of an outer parallel algorithm, is executed by this worker alone.
+
+namespace execution
+ {
+
+  constexpr std::size_t grain {4096} ;
+  constexpr std::size_t lanes {8} ;
+
+  template< bool Parallel, bool Vectorized >
+  struct Policy
+   {
+    static constexpr bool parallel {Parallel} ;
+    static constexpr bool vectorized {Vectorized} ;
+    WorkStealingPool * pool {nullptr} ;
+
+    // same policy, executed by the given pool rather than the default one
+    Policy on( WorkStealingPool & other ) const { return Policy{&other} ; }
+   } ;
+
+  using sequenced_policy = Policy<false,false> ;
+  using unsequenced_policy = Policy<false,true> ;
+  using parallel_policy = Policy<true,false> ;
+  using parallel_unsequenced_policy = Policy<true,true> ;
+
+  inline constexpr sequenced_policy seq {} ;
+  inline constexpr unsequenced_policy unseq {} ;
+  inline constexpr parallel_policy par {} ;
+  inline constexpr parallel_unsequenced_policy par_unseq {} ;
+
+  // one thread per core, created at the first parallel call
+  inline WorkStealingPool & default_pool()
+   {
+    static WorkStealingPool pool ;
+    return pool ;
+   }
+
+  inline std::size_t nb_chunks( std::size_t size )
+   { return (size+grain-1)/grain ; }
+
+  inline std::pair<std::size_t,std::size_t> chunk( std::size_t num, std::size_t size )
+   { return { num*grain, std::min((num+1)*grain,size) } ; }
+
+  // call f(k) for each k of [0,nb), spread over the threads of
+  // the pool if the policy is parallel, and wait for the end ;
+  // the first exception thrown by f, if any, is rethrown
+  template< bool Parallel, bool Vectorized, typename Function >
+  void for_tasks( Policy<Parallel,Vectorized> policy, std::size_t nb, Function f )
+   {
+    auto tasks = [&]( std::size_t first, std::size_t last )
+     {
+      for ( std::size_t k=first ; k<last ; ++k ) f(k) ;
+     } ;
+    if constexpr (!Parallel) tasks(0,nb) ;
+    else
+     {
+      WorkStealingPool & pool {policy.pool?*policy.pool:default_pool()} ;
+      if ((nb<2)||pool.is_worker()) { tasks(0,nb) ; return ; }
+      std::size_t nb_workers {std::min(pool.size(),nb)} ;
+      Partitioner partitioner(nb,nb_workers,Schedule::dynamic) ;
+      std::vector<std::future<void>> workers ;
+      for ( std::size_t num=0 ; num<nb_workers ; ++num )
+        workers.push_back(pool.submit([&,num]{ partitioner.run(num,tasks) ; })) ;
+      // all the workers must stop using the partitioner before leaving
+      for ( auto & worker : workers )
+       { worker.wait() ; }
+      for ( auto & worker : workers )
+       { worker.get() ; }
+     }
+   }
+
+  // call f(i) for each i of [begin,end)
+  template< bool Vectorized, typename Function >
+  void loop( std::size_t begin, std::size_t end, Function f )
+   {
+    if constexpr (Vectorized)
+     {
+      #pragma GCC ivdep
+      for ( std::size_t i=begin ; i<end ; ++i ) f(i) ;
+     }
+    else
+      for ( std::size_t i=begin ; i<end ; ++i ) f(i) ;
+   }
+
+  // reduce load(i) for each i of [begin,end), which must not be empty
+  template< bool Vectorized, typename T, typename Reduce, typename Load >
+  T fold( std::size_t begin, std::size_t end, Reduce reduce, Load load )
+   {
+    if constexpr (Vectorized && std::is_default_constructible_v<T>)
+      if (end-begin>=2*lanes)
+       {
+        std::array<T,lanes> acc ;
+        for ( std::size_t k=0 ; k<lanes ; ++k ) acc[k] = load(begin+k) ;
+        std::size_t i {begin+lanes} ;
+        for ( ; i+lanes<=end ; i+=lanes )
+          for ( std::size_t k=0 ; k<lanes ; ++k )
+            acc[k] = reduce(acc[k],load(i+k)) ;
+        T res {acc[0]} ;
+        for ( std::size_t k=1 ; k<lanes ; ++k ) res = reduce(res,acc[k]) ;
+        for ( ; i<end ; ++i ) res = reduce(res,load(i)) ;
+        return res ;
+       }
+    T res {load(begin)} ;
+    for ( std::size_t i=begin+1 ; i<end ; ++i ) res = reduce(res,load(i)) ;
+    return res ;
+   }
+
+  template< bool Parallel, bool Vectorized, std::random_access_iterator It, typename Function >
+  void for_each( Policy<Parallel,Vectorized> policy, It first, It last, Function f )
+   {
+    std::size_t size = last-first ;
+    for_tasks(policy,nb_chunks(size),[&]( std::size_t num )
+     {
+      auto [begin,end] = chunk(num,size) ;
+      loop<Vectorized>(begin,end,[&]( std::size_t i ){ f(first[i]) ; }) ;
+     }) ;
+   }
+
+  template< bool Parallel, bool Vectorized, std::random_access_iterator It,
+            std::random_access_iterator Out, typename Unary >
+  Out transform( Policy<Parallel,Vectorized> policy, It first, It last, Out d_first, Unary op )
+   {
+    std::size_t size = last-first ;
+    for_tasks(policy,nb_chunks(size),[&]( std::size_t num )
+     {
+      auto [begin,end] = chunk(num,size) ;
+      loop<Vectorized>(begin,end,[&]( std::size_t i ){ d_first[i] = op(first[i]) ; }) ;
+     }) ;
+    return d_first+size ;
+   }
+
+  template< bool Parallel, bool Vectorized, std::random_access_iterator It1,
+            std::random_access_iterator It2, std::random_access_iterator Out, typename Binary >
+  Out transform( Policy<Parallel,Vectorized> policy, It1 first1, It1 last1, It2 first2, Out d_first, Binary op )
+   {
+    std::size_t size = last1-first1 ;
+    for_tasks(policy,nb_chunks(size),[&]( std::size_t num )
+     {
+      auto [begin,end] = chunk(num,size) ;
+      loop<Vectorized>(begin,end,[&]( std::size_t i ){ d_first[i] = op(first1[i],first2[i]) ; }) ;
+     }) ;
+    return d_first+size ;
+   }
+
+  // each chunk is reduced by one thread, then the chunk results
+  // are reduced in order, starting from init
+  template< bool Parallel, bool Vectorized, std::random_access_iterator It,
+            typename T, typename Reduce, typename Unary >
+  T transform_reduce( Policy<Parallel,Vectorized> policy, It first, It last, T init, Reduce reduce, Unary op )
+   {
+    std::size_t size = last-first ;
+    std::vector<T> partials(nb_chunks(size),init) ;
+    for_tasks(policy,partials.size(),[&]( std::size_t num )
+     {
+      auto [begin,end] = chunk(num,size) ;
+      partials[num] = fold<Vectorized,T>(begin,end,reduce,[&]( std::size_t i ){ return T(op(first[i])) ; }) ;
+     }) ;
+    for ( auto const & partial : partials ) init = reduce(init,partial) ;
+    return init ;
+   }
+
+  template< bool Parallel, bool Vectorized, std::random_access_iterator It,
+            typename T, typename Reduce = std::plus<> >
+  T reduce( Policy<Parallel,Vectorized> policy, It first, It last, T init, Reduce op = {} )
+   { return transform_reduce(policy,first,last,init,op,std::identity{}) ; }
+
+  // the sums of the chunks are computed in parallel, then the offset
+  // of each chunk, sequentially, and the chunks are scanned in parallel
+  template< bool Parallel, bool Vectorized, std::random_access_iterator It,
+            std::random_access_iterator Out, typename Reduce = std::plus<> >
+  Out inclusive_scan( Policy<Parallel,Vectorized> policy, It first, It last, Out d_first, Reduce op = {} )
+   {
+    using T = std::iter_value_t<It> ;
+    std::size_t size = last-first ;
+    if (size==0) return d_first ;
+    std::size_t nb {nb_chunks(size)} ;
+    std::vector<T> sums(nb,first[0]) ;
+    for_tasks(policy,nb-1,[&]( std::size_t num )
+     {
+      auto [begin,end] = chunk(num,size) ;
+      sums[num] = fold<Vectorized,T>(begin,end,op,[&]( std::size_t i ){ return T(first[i]) ; }) ;
+     }) ;
+    for ( std::size_t num=1 ; num<nb-1 ; ++num )
+      sums[num] = op(sums[num-1],sums[num]) ;
+    for_tasks(policy,nb,[&]( std::size_t num )
+     {
+      auto [begin,end] = chunk(num,size) ;
+      T acc = (num==0)?T(first[begin]):op(sums[num-1],first[begin]) ;
+      d_first[begin] = acc ;
+      for ( std::size_t i=begin+1 ; i<end ; ++i )
+        d_first[i] = acc = op(acc,first[i]) ;
+     }) ;
+    return d_first+size ;
+   }
+
+  // the chunks are sorted in parallel, then merged two by two, all
+  // the pairs of a given width in parallel ; the last merge is done
+  // by a single thread
+  template< bool Parallel, bool Vectorized, std::random_access_iterator It,
+            typename Compare = std::less<> >
+  void sort( Policy<Parallel,Vectorized> policy, It first, It last, Compare comp = {} )
+   {
+    std::size_t size = last-first ;
+    if constexpr (!Parallel)
+     { std::sort(first,last,comp) ; }
+    else
+     {
+      for_tasks(policy,nb_chunks(size),[&]( std::size_t num )
+       {
+        auto [begin,end] = chunk(num,size) ;
+        std::sort(first+begin,first+end,comp) ;
+       }) ;
+      for ( std::size_t width=grain ; width<size ; width*=2 )
+        for_tasks(policy,(size+2*width-1)/(2*width),[&]( std::size_t num )
+         {
+          std::size_t begin {num*2*width} ;
+          std::size_t middle {std::min(begin+width,size)} ;
+          std::size_t end {std::min(begin+2*width,size)} ;
+          std::inplace_merge(first+begin,first+middle,first+end,comp) ;
+         }) ;
+     }
+   }
+
+ }
+
+#endif
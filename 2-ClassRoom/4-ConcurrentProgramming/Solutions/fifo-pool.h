@@ -0,0 +1,77 @@
+#ifndef FIFO_POOL_H
+#define FIFO_POOL_H
+
+#include <condition_variable>
+#include <cstddef> // for std::size_t
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of threads sharing a single queue of tasks, which
+// are started in the order they are submitted. Simpler than the
+// WorkStealingPool, but all the workers contend for the same lock.
+class FifoPool
+ {
+  public :
+
+    explicit FifoPool( std::size_t nb_workers = std::thread::hardware_concurrency() )
+     {
+      for ( std::size_t num=0 ; num<(nb_workers>0?nb_workers:1) ; ++num )
+        m_workers.emplace_back(&FifoPool::work,this) ;
+     }
+
+    FifoPool( FifoPool const & ) = delete ;
+    FifoPool & operator=( FifoPool const & ) = delete ;
+
+    // the remaining tasks are executed before the workers stop
+    ~FifoPool()
+     {
+       {
+        std::scoped_lock<std::mutex> lock(m_mutex) ;
+        m_stop = true ;
+       }
+      m_wake.notify_all() ;
+      for ( auto & worker : m_workers )
+       { worker.join() ; }
+     }
+
+    std::size_t size() const { return m_workers.size() ; }
+
+    // the task must not throw
+    void execute( std::function<void()> task )
+     {
+       {
+        std::scoped_lock<std::mutex> lock(m_mutex) ;
+        m_tasks.push_back(std::move(task)) ;
+       }
+      m_wake.notify_one() ;
+     }
+
+  private :
+
+    void work()
+     {
+      while (true)
+       {
+        std::function<void()> task ;
+         {
+          std::unique_lock<std::mutex> lock(m_mutex) ;
+          m_wake.wait(lock,[this]{ return m_stop || !m_tasks.empty() ; }) ;
+          if (m_tasks.empty()) return ;
+          task = std::move(m_tasks.front()) ;
+          m_tasks.pop_front() ;
+         }
+        task() ;
+       }
+     }
+
+    std::vector<std::thread> m_workers ;
+    std::mutex m_mutex ;
+    std::condition_variable m_wake ;
+    std::deque<std::function<void()>> m_tasks ;
+    bool m_stop {false} ;
+ } ;
+
+#endif
@@ -0,0 +1,76 @@
+#include <cassert>
+#include <cstdio> // for std::snprintf
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logger.h"
+
+// two loggers written alternately from the same thread : each one keeps
+// a single ring for this thread, and writes all its messages in order
+void two_loggers( std::size_t nb_messages )
+ {
+  std::ostringstream os1, os2 ;
+   {
+    Logger logger1 {os1,nb_messages}, logger2 {os2,nb_messages} ;
+    for ( std::size_t i=0 ; i<nb_messages ; ++i )
+     {
+      logger1.log("one "+std::to_string(i)) ;
+      logger2.log("two "+std::to_string(i)) ;
+     }
+    assert(logger1.nb_rings()==1) ;
+    assert(logger2.nb_rings()==1) ;
+   }
+  std::istringstream is1 {os1.str()}, is2 {os2.str()} ;
+  std::string line1, line2 ;
+  for ( std::size_t i=0 ; i<nb_messages ; ++i )
+   {
+    std::getline(is1,line1) ;
+    std::getline(is2,line2) ;
+    assert(line1=="one "+std::to_string(i)) ;
+    assert(line2=="two "+std::to_string(i)) ;
+   }
+  assert(!std::getline(is1,line1)) ;
+  assert(!std::getline(is2,line2)) ;
+ }
+
+// several threads write to the same logger : all the messages are
+// written, and those of each thread in the order of the thread
+void many_threads( std::size_t nb_threads, std::size_t nb_messages )
+ {
+  std::ostringstream os ;
+   {
+    Logger logger {os,nb_messages} ;
+    std::vector<std::thread> threads ;
+    for ( std::size_t num=0 ; num<nb_threads ; ++num )
+      threads.emplace_back([&logger,num,nb_messages]
+       {
+        for ( std::size_t i=0 ; i<nb_messages ; ++i )
+         {
+          char message[Logger::message_size_max] ;
+          int size {std::snprintf(message,sizeof(message),"%zu %zu",num,i)} ;
+          logger.log({message,static_cast<std::size_t>(size)}) ;
+         }
+       }) ;
+    for ( auto & thread : threads ) thread.join() ;
+    assert(logger.nb_rings()==nb_threads) ;
+   }
+  std::istringstream is {os.str()} ;
+  std::vector<std::size_t> next(nb_threads,0) ;
+  std::size_t num, i ;
+  while (is>>num>>i)
+   {
+    assert((num<nb_threads)&&(i==next[num])) ;
+    ++next[num] ;
+   }
+  assert(is.eof()) ; // nothing dropped
+  for ( std::size_t count : next ) assert(count==nb_messages) ;
+ }
+
+int main()
+ {
+  two_loggers(2000) ;
+  many_threads(4,10000) ;
+  std::cout<<"logger tests passed"<<std::endl ;
+ }
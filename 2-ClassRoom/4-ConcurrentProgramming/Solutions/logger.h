@@ -0,0 +1,176 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <algorithm> // for std::min, std::stable_sort & std::upper_bound
+#include <atomic>
+#include <chrono>
+#include <cstddef> // for std::size_t
+#include <cstring> // for std::memcpy
+#include <iostream>
+#include <memory> // for std::unique_ptr
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility> // for std::pair
+#include <vector>
+
+// Logging without any lock on the hot path :
+// - each thread writing to the logger gets its own ring buffer of fixed
+//   capacity, where it is the only producer ;
+// - one background thread is the only consumer of all the rings, and
+//   regularly writes their messages to the stream, in timestamp order :
+//   a message is held back until no ring can still deliver an older one ;
+// - when its ring is full, a thread does not wait : the message is dropped,
+//   and only counted, so that the memory stays bounded and that a worker
+//   never blocks on the I/O.
+// The only lock is taken once per thread and logger, when the ring of the
+// thread in this logger is created. The logger must be destroyed after
+// the end of the threads which write to it.
+class Logger
+ {
+  public :
+
+    static constexpr std::size_t message_size_max {112} ;
+
+    explicit Logger( std::ostream & os = std::cout, std::size_t capacity = 1024 )
+     : m_os{os}, m_capacity{capacity}, m_drainer{&Logger::drain,this} {}
+
+    Logger( Logger const & ) = delete ;
+    Logger & operator=( Logger const & ) = delete ;
+
+    // all the pending messages are written before the drainer stops
+    ~Logger()
+     {
+      m_stop = true ;
+      m_drainer.join() ;
+     }
+
+    // longer messages are truncated
+    void log( std::string_view message )
+     {
+      Ring & ring {local_ring()} ;
+      std::size_t tail {ring.tail.load(std::memory_order_relaxed)} ;
+      if (tail-ring.head.load(std::memory_order_acquire)==m_capacity)
+       {
+        ring.dropped.fetch_add(1,std::memory_order_relaxed) ;
+        return ;
+       }
+      Record & record {ring.records[tail%m_capacity]} ;
+      // announced before the clock is read, see collect()
+      ring.writing.store(true) ;
+      record.time = std::chrono::steady_clock::now() ;
+      record.size = std::min(message.size(),message_size_max) ;
+      std::memcpy(record.text,message.data(),record.size) ;
+      ring.tail.store(tail+1,std::memory_order_release) ;
+      ring.writing.store(false,std::memory_order_release) ;
+     }
+
+    // number of rings, that is of threads which have written to the logger
+    std::size_t nb_rings()
+     {
+      std::scoped_lock<std::mutex> lock(m_mutex) ;
+      return m_rings.size() ;
+     }
+
+  private :
+
+    struct Record
+     {
+      std::chrono::steady_clock::time_point time ;
+      std::size_t size {0} ;
+      char text[message_size_max] ;
+     } ;
+
+    using Time = std::chrono::steady_clock::time_point ;
+
+    // single producer, single consumer
+    struct Ring
+     {
+      explicit Ring( std::size_t capacity ) : records(capacity) {}
+      std::vector<Record> records ;
+      alignas(64) std::atomic<std::size_t> head {0} ;
+      Time last {Time::min()} ; // of the last record read by the consumer
+      alignas(64) std::atomic<std::size_t> tail {0} ;
+      std::atomic<bool> writing {false} ;
+      std::atomic<std::size_t> dropped {0} ;
+     } ;
+
+    // the ring of the calling thread in this logger ; each thread keeps
+    // its rings by logger id rather than address, which may be reused by
+    // a later logger, and the few bytes of the entries of the destroyed
+    // loggers are only freed at the end of the thread
+    Ring & local_ring()
+     {
+      thread_local std::vector<std::pair<std::size_t,Ring *>> rings ;
+      for ( auto itr=rings.rbegin() ; itr!=rings.rend() ; ++itr )
+        if (itr->first==m_id) return *itr->second ;
+      std::scoped_lock<std::mutex> lock(m_mutex) ;
+      m_rings.push_back(std::make_unique<Ring>(m_capacity)) ;
+      rings.emplace_back(m_id,m_rings.back().get()) ;
+      return *m_rings.back() ;
+     }
+
+    // move all the available messages into pending, and return the time
+    // up to which no older message can come anymore : a ring which is
+    // not writing will only deliver messages stamped after the current
+    // time, and a ring which is writing a message will stamp it after
+    // its last one, since the flag is set before the clock is read
+    Time collect( std::vector<Record> & pending, std::size_t & dropped )
+     {
+      Time limit {std::chrono::steady_clock::now()} ;
+      std::scoped_lock<std::mutex> lock(m_mutex) ;
+      for ( auto & ring : m_rings )
+       {
+        bool writing {ring->writing.load()} ;
+        std::size_t head {ring->head.load(std::memory_order_relaxed)} ;
+        std::size_t tail {ring->tail.load(std::memory_order_acquire)} ;
+        for ( ; head<tail ; ++head )
+         {
+          pending.push_back(ring->records[head%m_capacity]) ;
+          ring->last = pending.back().time ;
+         }
+        ring->head.store(head,std::memory_order_release) ;
+        dropped += ring->dropped.exchange(0,std::memory_order_relaxed) ;
+        if (writing) limit = std::min(limit,ring->last) ;
+       }
+      return limit ;
+     }
+
+    // write the messages in time order, up to the limit given by
+    // collect(), or all of them at the end
+    void drain()
+     {
+      std::vector<Record> pending ;
+      std::size_t dropped {0} ;
+      bool stop {false} ;
+      auto older = []( Record const & r1, Record const & r2 ){ return r1.time<r2.time ; } ;
+      while (!stop)
+       {
+        stop = m_stop ;
+        Time limit {collect(pending,dropped)} ;
+        std::stable_sort(pending.begin(),pending.end(),older) ;
+        auto end {pending.end()} ;
+        if (!stop)
+          end = std::upper_bound(pending.begin(),pending.end(),limit,[]( Time time, Record const & record )
+           { return time<record.time ; }) ;
+        for ( auto itr=pending.begin() ; itr!=end ; ++itr )
+         { m_os.write(itr->text,itr->size)<<'\n' ; }
+        pending.erase(pending.begin(),end) ;
+        if (stop && (dropped>0))
+         { m_os<<"("<<dropped<<" messages dropped)\n" ; }
+        m_os.flush() ;
+        if (!stop) std::this_thread::sleep_for(std::chrono::milliseconds(1)) ;
+       }
+     }
+
+    static inline std::atomic<std::size_t> s_nb_loggers {0} ;
+    std::size_t m_id {++s_nb_loggers} ;
+    std::ostream & m_os ;
+    std::size_t m_capacity ;
+    std::mutex m_mutex ;
+    std::vector<std::unique_ptr<Ring>> m_rings ;
+    std::atomic<bool> m_stop {false} ;
+    std::thread m_drainer ;
+ } ;
+
+#endif
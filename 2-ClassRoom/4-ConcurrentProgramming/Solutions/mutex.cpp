@@ -1,79 +1,102 @@
-#include <complex>
-#include <vector>
-#include <iostream>
+#include "partitioner.h"
+#include "product.h"
+#include "power.h"
+#include "philox.h"
+#include "topology.h"
+#include "logger.h"
 #include <cassert>
 #include <cmath>
+#include <complex>
+#include <cstdio> // for std::snprintf
+#include <iostream>
+#include <span>
+#include <string_view>
 #include <thread>
-#include <mutex>
+#include <vector>
 
 using Real = double ;
 using Complex = std::complex<Real> ;
 using Complexes = std::vector<Complex> ;
 
-// random unitary complexes
-void generate( Complexes & cs )
- {
-  srand(1) ;
-  for ( auto & c : cs )
-   { 
-    Real angle {rand()/(Real(RAND_MAX)+1)*2.0*M_PI} ;
-    c = Complex{std::cos(angle),std::sin(angle)} ;
-   }
- }
+// random unitary complexes : the numbers [first,first+cs.size())
+// of a single sequence, so that any thread can generate any slice
+void generate( std::span<Complex> cs, std::size_t first = 0 )
+ { philox::Philox{1}.unit_complexes(cs,first) ; }
 
-// compute a slice of xs^degree and store it into ys
+// generate the ranges of xs given to the worker num_worker
+// by the partitioner, then compute their power into ys ;
+// the messages are formatted on the stack, and the
+// logger never blocks the worker
 void complexes_pow
- ( std::size_t num_slice, std::size_t nb_slices,
-   Complexes const & xs, int degree, Complexes & ys )
+ ( std::size_t num_worker, Partitioner & partitioner, Logger & logger,
+   Complexes & xs, power::Algorithm algorithm, int degree, Complexes & ys )
  {
-  assert((xs.size()%nb_slices)==0) ;  
-  auto slice_size {xs.size()/nb_slices} ;
-  auto min {num_slice*slice_size} ;
-  auto max {(num_slice+1)*slice_size} ;
-   {
-  static std::mutex m ;
-  std::scoped_lock<std::mutex> l(m) ;
-  std::cout<<"complexes_pow "<<num_slice<<" min : "<<min<<std::endl ;     
-  std::cout<<"complexes_pow "<<num_slice<<" max : "<<max<<std::endl ;
-   } 
-  for ( auto i {min} ; i<max ; ++i )
+  partitioner.run(num_worker,[&]( std::size_t min, std::size_t max )
    {
-    ys[i] = Complex{1.,0.} ;
-    for ( int d=0 ; d<degree ; ++d )
-     { ys[i] *= xs[i] ; }
-   }
+    char message[Logger::message_size_max] ;
+    int size {std::snprintf(message,sizeof(message),"complexes_pow %zu min : %zu",num_worker,min)} ;
+    logger.log({message,static_cast<std::size_t>(size)}) ;
+    size = std::snprintf(message,sizeof(message),"complexes_pow %zu max : %zu",num_worker,max) ;
+    logger.log({message,static_cast<std::size_t>(size)}) ;
+    generate({xs.data()+min,max-min},min) ;
+    power::raise(algorithm,max-min,xs.data()+min,degree,ys.data()+min) ;
+   }) ;
  }
 
-// display the angle of the complexes global product
-void postprocess( Complexes const & cs )
+// display the angle of the global product, computed by nb_threads,
+// either by multiplying the complexes, or by summing their angles
+void postprocess( Complexes const & cs, std::size_t nb_threads, bool polar )
  {
-  Complex prod(1.,0.) ;
-  for( auto c : cs ) { prod *= c ; }
-  double angle {atan2(prod.imag(),prod.real())} ;
+  double angle ;
+  if (polar)
+   { angle = std::remainder(product::polar<Real>(cs,nb_threads).angle,2.*M_PI) ; }
+  else
+   {
+    Complex prod {product::cartesian<Real>(cs,nb_threads)} ;
+    angle = atan2(prod.imag(),prod.real()) ;
+   }
   std::cout<<"result = "<<static_cast<int>(angle/2./M_PI*360.)<<"\n" ;
  }
 
 // main program
 int main ( int argc, char * argv[] )
  {
-  assert(argc==4) ;
+  assert((argc>=4)&&(argc<=9)) ;
   std::size_t nbtasks {std::stoul(argv[1])} ;
   std::size_t dim {std::stoul(argv[2])} ;
   int degree {std::stoi(argv[3])} ;
+  Schedule schedule {select_schedule((argc>4)?argv[4]:"block")} ;
+  std::size_t chunk {(argc>5)?std::stoul(argv[5]):1} ;
+  std::string_view mode {(argc>6)?argv[6]:"cartesian"} ;
+  assert((mode=="cartesian")||(mode=="polar")) ;
+  Pinning pinning {select_pinning((argc>7)?argv[7]:"none")} ;
+  power::Algorithm algorithm {power::select_algorithm((argc>8)?argv[8]:"squaring")} ;
 
-  // prepare input
+  // prepare input and compute
   Complexes input(dim) ;
-  generate(input) ;
-   
-  // compute
   Complexes output(dim) ;
-  std::size_t numtask ;
-  std::vector<std::thread> workers ;
-  for ( numtask = 0 ; numtask<nbtasks ; ++numtask )
-   { workers.emplace_back(complexes_pow,numtask,nbtasks,std::ref(input),degree,std::ref(output)) ; }
-  for ( auto & worker : workers )
-   { worker.join() ; }
+  Partitioner partitioner(dim,nbtasks,schedule,chunk) ;
+  Topology topology ;
+  std::vector<unsigned> cpus {topology.placement(pinning,nbtasks)} ;
+   {
+    Logger logger ;
+    std::size_t numtask ;
+    std::vector<std::thread> workers ;
+    for ( numtask = 0 ; numtask<nbtasks ; ++numtask )
+     {
+      // each worker pins itself before it first touches its input
+      workers.emplace_back([&,numtask]
+       {
+        if (!cpus.empty()) pin_current(cpus[numtask]) ;
+        complexes_pow(numtask,partitioner,logger,input,algorithm,degree,output) ;
+       }) ;
+     }
+    for ( auto & worker : workers )
+     { worker.join() ; }
+   }
+  if (!cpus.empty()) topology.report(std::cerr) ;
+  partitioner.report(std::cerr) ;
   
   // post-process
-  postprocess(output) ;
+  postprocess(output,nbtasks,mode=="polar") ;
  }
@@ -0,0 +1,136 @@
+#ifndef PARTITIONER_H
+#define PARTITIONER_H
+
+#include <algorithm> // for std::min & std::max
+#include <atomic>
+#include <cassert> // for assert
+#include <chrono>
+#include <cstddef> // for std::size_t
+#include <optional>
+#include <ostream>
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+#include <utility> // for std::pair
+#include <vector>
+
+// How the indices [0,size) are distributed among nb_workers :
+// - block : one contiguous range per worker, the first ones
+//   getting one more element when size is not a multiple ;
+// - cyclic : ranges of chunk elements, dealt in turn to each worker ;
+// - guided : each worker takes, from a shared counter, the remaining
+//   elements divided by twice the number of workers, at least chunk ;
+// - dynamic : each worker takes chunk elements from a shared counter.
+// The two first ones are static, with no synchronization at all, while
+// the two last ones balance the load if some workers are slower.
+enum class Schedule { block, cyclic, guided, dynamic } ;
+
+inline Schedule select_schedule( std::string_view name )
+ {
+  if (name=="block") return Schedule::block ;
+  if (name=="cyclic") return Schedule::cyclic ;
+  if (name=="guided") return Schedule::guided ;
+  if (name=="dynamic") return Schedule::dynamic ;
+  throw std::runtime_error("unknown schedule: "+std::string(name)) ;
+ }
+
+// each worker num calls run(num,f), which calls f(begin,end) for each
+// of its ranges, and measures the time spent in f
+class Partitioner
+ {
+  public :
+
+    Partitioner( std::size_t size, std::size_t nb_workers, Schedule schedule, std::size_t chunk = 1 )
+     : m_size{size}, m_schedule{schedule}, m_chunk{std::max(chunk,std::size_t{1})},
+       m_workers(nb_workers)
+     {
+      assert(nb_workers>0) ;
+      for ( std::size_t num=0 ; num<nb_workers ; ++num )
+        m_workers[num].next = (m_schedule==Schedule::cyclic)?num*m_chunk:0 ;
+     }
+
+    std::size_t nb_workers() const { return m_workers.size() ; }
+
+    // next range [begin,end) of the worker num, if any
+    std::optional<std::pair<std::size_t,std::size_t>> next( std::size_t num )
+     {
+      Worker & worker {m_workers[num]} ;
+      std::size_t nb {m_workers.size()} ;
+      std::size_t begin, end ;
+      switch (m_schedule)
+       {
+        case Schedule::block :
+          if (worker.nb_ranges>0) return std::nullopt ;
+          begin = num*(m_size/nb) + std::min(num,m_size%nb) ;
+          end = begin + m_size/nb + ((num<m_size%nb)?1:0) ;
+          break ;
+        case Schedule::cyclic :
+          begin = worker.next ;
+          end = std::min(begin+m_chunk,m_size) ;
+          worker.next += nb*m_chunk ;
+          break ;
+        case Schedule::guided :
+          begin = m_counter.load() ;
+          do
+           {
+            if (begin>=m_size) return std::nullopt ;
+            end = std::min(begin+std::max((m_size-begin)/(2*nb),m_chunk),m_size) ;
+           }
+          while (!m_counter.compare_exchange_weak(begin,end)) ;
+          break ;
+        default :
+          begin = m_counter.fetch_add(m_chunk) ;
+          end = std::min(begin+m_chunk,m_size) ;
+       }
+      if (begin>=end) return std::nullopt ;
+      ++worker.nb_ranges ;
+      return std::pair{begin,end} ;
+     }
+
+    template< typename Function >
+    void run( std::size_t num, Function f )
+     {
+      using namespace std::chrono ;
+      while (auto range = next(num))
+       {
+        auto t1 {steady_clock::now()} ;
+        f(range->first,range->second) ;
+        auto t2 {steady_clock::now()} ;
+        m_workers[num].busy += duration<double>(t2-t1).count() ;
+       }
+     }
+
+    // busy time and number of ranges of each worker, then the
+    // imbalance, which is the max busy time divided by the mean
+    void report( std::ostream & os ) const
+     {
+      double total {0.}, max {0.} ;
+      for ( std::size_t num=0 ; num<m_workers.size() ; ++num )
+       {
+        Worker const & worker {m_workers[num]} ;
+        os<<"(worker "<<num<<" busy: "<<static_cast<long>(worker.busy*1e6)<<" us, "
+          <<worker.nb_ranges<<" ranges)\n" ;
+        total += worker.busy ;
+        max = std::max(max,worker.busy) ;
+       }
+      if (total>0.) os<<"(imbalance: "<<max*m_workers.size()/total<<")\n" ;
+     }
+
+  private :
+
+    // one cache line per worker, since each one updates its own
+    struct alignas(64) Worker
+     {
+      std::size_t next {0} ;
+      std::size_t nb_ranges {0} ;
+      double busy {0.} ;
+     } ;
+
+    std::size_t m_size ;
+    Schedule m_schedule ;
+    std::size_t m_chunk ;
+    std::vector<Worker> m_workers ;
+    alignas(64) std::atomic<std::size_t> m_counter {0} ;
+ } ;
+
+#endif
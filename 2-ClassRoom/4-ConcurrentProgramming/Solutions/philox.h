@@ -0,0 +1,175 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <algorithm> // for std::min & std::max
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef> // for std::size_t
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+
+// Counter-based random numbers, with the Philox4x32-10 function of
+// Salmon et al. (Random123) : the block number n of a stream is only
+// a hash of n, the stream number and the seed, with no state carried
+// from one number to the next. Thus :
+// - any thread can compute any part of a sequence, without going
+//   through the previous numbers, and get the same values as a serial
+//   run : the fill functions below take the index of the first number ;
+// - the blocks of a batch are computed together, with plain integer
+//   arithmetic that the compiler can vectorize.
+//
+// Each block is made of four 32 bits words, which give two doubles
+// with 53 random bits, hence two uniform numbers, or two normal ones,
+// or two unit complexes.
+
+namespace philox
+ {
+
+  using Block = std::array<std::uint32_t,4> ;
+
+  constexpr std::size_t lanes {8} ;
+
+  class Philox
+   {
+    public :
+
+      using result_type = std::uint32_t ;
+
+      explicit Philox( std::uint64_t seed = 1, std::uint64_t stream = 0 )
+       : m_key{static_cast<std::uint32_t>(seed),static_cast<std::uint32_t>(seed>>32)},
+         m_stream{stream} {}
+
+      // the block number num of the stream
+      Block block( std::uint64_t num ) const
+       {
+        std::uint32_t c0, c1, c2, c3 ;
+        rounds<1>(num,&c0,&c1,&c2,&c3) ;
+        return { c0, c1, c2, c3 } ;
+       }
+
+      // the words one by one, as a std::uniform_random_bit_generator,
+      // so that it can be given to the std distributions
+      static constexpr result_type min() { return 0 ; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max() ; }
+      result_type operator()()
+       {
+        if (m_position/4!=m_cached)
+         {
+          m_cached = m_position/4 ;
+          m_block = block(m_cached) ;
+         }
+        return m_block[m_position++%4] ;
+       }
+
+      // skip ahead, in O(1)
+      void discard( std::uint64_t nb_words ) { m_position += nb_words ; }
+
+      // uniform numbers in [0,1)
+      template< typename Real >
+      void uniform( std::span<Real> out, std::uint64_t first = 0 ) const
+       {
+        fill_pairs(out,first,[]( double u0, double u1, Real & y0, Real & y1 )
+         {
+          y0 = static_cast<Real>(u0) ;
+          y1 = static_cast<Real>(u1) ;
+         }) ;
+       }
+
+      // normal numbers, with mean 0 and variance 1 (Box-Muller)
+      template< typename Real >
+      void normal( std::span<Real> out, std::uint64_t first = 0 ) const
+       {
+        fill_pairs(out,first,[]( double u0, double u1, Real & y0, Real & y1 )
+         {
+          double radius {std::sqrt(-2.*std::log(1.-u0))} ;
+          double angle {2.*std::numbers::pi*u1} ;
+          y0 = static_cast<Real>(radius*std::cos(angle)) ;
+          y1 = static_cast<Real>(radius*std::sin(angle)) ;
+         }) ;
+       }
+
+      // complexes of norm 1, with a uniform angle in [0,2pi)
+      template< typename Real >
+      void unit_complexes( std::span<std::complex<Real>> out, std::uint64_t first = 0 ) const
+       {
+        fill_pairs(out,first,[]( double u0, double u1, std::complex<Real> & y0, std::complex<Real> & y1 )
+         {
+          double a0 {2.*std::numbers::pi*u0}, a1 {2.*std::numbers::pi*u1} ;
+          y0 = { static_cast<Real>(std::cos(a0)), static_cast<Real>(std::sin(a0)) } ;
+          y1 = { static_cast<Real>(std::cos(a1)), static_cast<Real>(std::sin(a1)) } ;
+         }) ;
+       }
+
+    private :
+
+      static constexpr std::uint32_t m0 {0xD2511F53}, m1 {0xCD9E8D57} ;
+      static constexpr std::uint32_t w0 {0x9E3779B9}, w1 {0xBB67AE85} ;
+
+      // the blocks [first,first+nb) of the stream : nb is lanes for
+      // a batch, or 1 for a single block
+      template< std::size_t nb >
+      void rounds( std::uint64_t first, std::uint32_t * c0, std::uint32_t * c1, std::uint32_t * c2, std::uint32_t * c3 ) const
+       {
+        for ( std::size_t k=0 ; k<nb ; ++k )
+         {
+          c0[k] = static_cast<std::uint32_t>(first+k) ;
+          c1[k] = static_cast<std::uint32_t>((first+k)>>32) ;
+          c2[k] = static_cast<std::uint32_t>(m_stream) ;
+          c3[k] = static_cast<std::uint32_t>(m_stream>>32) ;
+         }
+        std::uint32_t k0 {m_key[0]}, k1 {m_key[1]} ;
+        for ( int round=0 ; round<10 ; ++round )
+         {
+          for ( std::size_t k=0 ; k<nb ; ++k )
+           {
+            std::uint64_t p0 {std::uint64_t{m0}*c0[k]} ;
+            std::uint64_t p1 {std::uint64_t{m1}*c2[k]} ;
+            std::uint32_t x0 = static_cast<std::uint32_t>(p1>>32)^c1[k]^k0 ;
+            std::uint32_t x2 = static_cast<std::uint32_t>(p0>>32)^c3[k]^k1 ;
+            c1[k] = static_cast<std::uint32_t>(p1) ;
+            c3[k] = static_cast<std::uint32_t>(p0) ;
+            c0[k] = x0 ;
+            c2[k] = x2 ;
+           }
+          k0 += w0 ;
+          k1 += w1 ;
+         }
+       }
+
+      // 53 random bits, as a double in [0,1)
+      static double to_unit( std::uint32_t high, std::uint32_t low )
+       { return static_cast<double>(((std::uint64_t{high}<<32)|low)>>11)*0x1.0p-53 ; }
+
+      // the number i of the sequence is the value y(i%2) given by
+      // make(u0,u1,y0,y1) for the block i/2 ; fill out with the
+      // numbers [first,first+out.size())
+      template< typename T, typename Make >
+      void fill_pairs( std::span<T> out, std::uint64_t first, Make make ) const
+       {
+        std::uint64_t end {first+out.size()} ;
+        for ( std::uint64_t num=first/2 ; 2*num<end ; num+=lanes )
+         {
+          std::uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes] ;
+          rounds<lanes>(num,c0,c1,c2,c3) ;
+          T y0[lanes], y1[lanes] ;
+          for ( std::size_t k=0 ; k<lanes ; ++k )
+            make(to_unit(c0[k],c1[k]),to_unit(c2[k],c3[k]),y0[k],y1[k]) ;
+          std::uint64_t begin {std::max(2*num,first)}, last {std::min(2*(num+lanes),end)} ;
+          for ( std::uint64_t i=begin ; i<last ; ++i )
+            out[i-first] = (i%2==0)?y0[i/2-num]:y1[i/2-num] ;
+         }
+       }
+
+      std::array<std::uint32_t,2> m_key ;
+      std::uint64_t m_stream ;
+      std::uint64_t m_position {0} ;
+      std::uint64_t m_cached {std::numeric_limits<std::uint64_t>::max()} ;
+      Block m_block {} ;
+   } ;
+
+ }
+
+#endif
@@ -0,0 +1,84 @@
+#include <complex>
+#include <vector>
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "sender.h"
+#include "power.h"
+#include "philox.h"
+#include "product.h"
+
+using Real = double ;
+using Complex = std::complex<Real> ;
+using Complexes = std::vector<Complex> ;
+
+// random unitary complexes : the numbers [first,first+cs.size())
+// of a single sequence, so that any thread can generate any slice
+void generate( std::span<Complex> cs, std::size_t first = 0 )
+ { philox::Philox{1}.unit_complexes(cs,first) ; }
+
+// compute xs^degree and store it into ys, of same size
+void complexes_pow( std::span<Complex const> xs, int degree, std::span<Complex> ys )
+ { power::squaring(xs.size(),xs.data(),degree,ys.data()) ; }
+
+// display the angle of the global product
+void postprocess( Complex prod )
+ {
+  double angle {atan2(prod.imag(),prod.real())} ;
+  std::cout<<"result = "<<static_cast<int>(angle/2./M_PI*360.)<<"\n" ;
+ }
+
+// each chunk is generated, raised to the power and reduced by its own
+// chain of senders, on the scheduler : the random numbers of a chunk do
+// not depend on the previous ones, so that the generation of the next
+// chunks overlaps the computation of the first ones ; the product is
+// reduced by fixed leaves, whatever the chunks, to be reproducible
+template< typename Scheduler >
+void process( Scheduler scheduler, std::size_t nbchunks, std::size_t dim, int degree )
+ {
+  using namespace sender ;
+  Complexes input(dim), output(dim) ;
+  product::Cartesian<Real> prod {output} ;
+  AsyncScope scope ;
+  for ( std::size_t numchunk {0} ; numchunk<nbchunks ; ++numchunk )
+   {
+    std::size_t begin {numchunk*dim/nbchunks}, end {(numchunk+1)*dim/nbchunks} ;
+    std::span<Complex> xs {input.data()+begin,end-begin} ;
+    std::span<Complex> ys {output.data()+begin,end-begin} ;
+    scope.spawn(just(ys)
+      | transfer(scheduler)
+      | then([xs,begin]( std::span<Complex> ys ){ generate(xs,begin) ; return ys ; })
+      | then([xs,degree]( std::span<Complex> ys ){ complexes_pow(xs,degree,ys) ; return ys ; })
+      | then([&prod,begin,end]( std::span<Complex> ){ prod.complete(begin,end) ; })) ;
+   }
+  scope.join() ;
+  postprocess(prod.result()) ;
+ }
+
+// main program
+int main ( int argc, char * argv[] )
+ {
+  assert((argc>=4)&&(argc<=5)) ;
+  std::size_t nbchunks {std::stoul(argv[1])} ;
+  std::size_t dim {std::stoul(argv[2])} ;
+  int degree {std::stoi(argv[3])} ;
+  std::string_view name {(argc>4)?argv[4]:"stealing"} ;
+
+  if (name=="inline")
+   { process(sender::InlineScheduler{},nbchunks,dim,degree) ; }
+  else if (name=="fifo")
+   {
+    FifoPool pool ;
+    process(sender::FifoScheduler{&pool},nbchunks,dim,degree) ;
+   }
+  else if (name=="stealing")
+   {
+    WorkStealingPool pool ;
+    process(sender::WorkStealingScheduler{&pool},nbchunks,dim,degree) ;
+   }
+  else throw std::runtime_error("unknown scheduler: "+std::string(name)) ;
+ }
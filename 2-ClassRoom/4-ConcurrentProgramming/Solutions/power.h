@@ -0,0 +1,116 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <algorithm> // for std::min
+#include <cmath>
+#include <complex>
+#include <cstddef> // for std::size_t
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+
+// Integer power of many complex numbers, ys[i] = xs[i]^degree.
+//
+// squaring() needs O(log(degree)) products instead of degree, and works
+// on batches of numbers split into real and imaginary arrays, with plain
+// Real arithmetic rather than the std::complex product and its special
+// cases for infinities : the loops over a batch are vectorized.
+//
+// polar() is O(1) whatever the degree : the angle is multiplied by the
+// degree, and the norm raised to the power degree. It is fastest when
+// the degree is high, but its error grows with the degree.
+//
+// The programs choose one of them by name, with select_algorithm(),
+// and call it through raise().
+
+namespace power
+ {
+
+  constexpr std::size_t lanes {8} ;
+
+  template< typename Real >
+  void squaring( std::size_t size, std::complex<Real> const * xs, int degree, std::complex<Real> * ys )
+   {
+    bool inverse {degree<0} ;
+    unsigned int exponent = inverse?-static_cast<unsigned int>(degree):degree ;
+    for ( std::size_t begin=0 ; begin<size ; begin+=lanes )
+     {
+      std::size_t count {std::min(lanes,size-begin)} ;
+
+      // split the batch, padded with ones
+      Real xr[lanes], xi[lanes], yr[lanes], yi[lanes] ;
+      for ( std::size_t k=0 ; k<lanes ; ++k )
+       {
+        xr[k] = (k<count)?xs[begin+k].real():1 ;
+        xi[k] = (k<count)?xs[begin+k].imag():0 ;
+        yr[k] = 1 ;
+        yi[k] = 0 ;
+       }
+
+      // for each bit of the exponent, from the lowest one
+      for ( unsigned int e=exponent ; e>0 ; e/=2 )
+       {
+        if (e%2)
+          for ( std::size_t k=0 ; k<lanes ; ++k )
+           {
+            Real r {yr[k]*xr[k]-yi[k]*xi[k]} ;
+            yi[k] = yr[k]*xi[k]+yi[k]*xr[k] ;
+            yr[k] = r ;
+           }
+        if (e>1)
+          for ( std::size_t k=0 ; k<lanes ; ++k )
+           {
+            Real r {xr[k]*xr[k]-xi[k]*xi[k]} ;
+            xi[k] = 2*xr[k]*xi[k] ;
+            xr[k] = r ;
+           }
+       }
+
+      // 1/y = conj(y)/norm(y)
+      if (inverse)
+        for ( std::size_t k=0 ; k<lanes ; ++k )
+         {
+          Real norm {yr[k]*yr[k]+yi[k]*yi[k]} ;
+          yr[k] = yr[k]/norm ;
+          yi[k] = -yi[k]/norm ;
+         }
+
+      for ( std::size_t k=0 ; k<count ; ++k )
+        ys[begin+k] = { yr[k], yi[k] } ;
+     }
+   }
+
+  // for unit complexes, as given by generate(), set unit to true
+  // to skip the computation of the norm
+  template< typename Real >
+  void polar( std::size_t size, std::complex<Real> const * xs, int degree, std::complex<Real> * ys, bool unit = false )
+   {
+    for ( std::size_t i=0 ; i<size ; ++i )
+     {
+      Real angle {std::atan2(xs[i].imag(),xs[i].real())*degree} ;
+      Real norm = unit?1:std::pow(std::abs(xs[i]),degree) ;
+      ys[i] = { norm*std::cos(angle), norm*std::sin(angle) } ;
+     }
+   }
+
+  enum class Algorithm { squaring, polar } ;
+
+  // algorithm for a name among squaring|polar
+  inline Algorithm select_algorithm( std::string_view name )
+   {
+    if (name=="squaring") return Algorithm::squaring ;
+    if (name=="polar") return Algorithm::polar ;
+    throw std::runtime_error("unknown power algorithm: "+std::string(name)) ;
+   }
+
+  // ys[i] = xs[i]^degree with the given algorithm, for unit complexes
+  template< typename Real >
+  void raise( Algorithm algorithm, std::size_t size, std::complex<Real> const * xs, int degree, std::complex<Real> * ys )
+   {
+    if (algorithm==Algorithm::polar) polar(size,xs,degree,ys,true) ;
+    else squaring(size,xs,degree,ys) ;
+   }
+
+ }
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef PRODUCT_H
+#define PRODUCT_H
+
+#include "partitioner.h"
+#include <algorithm> // for std::min & std::max
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstddef> // for std::size_t
+#include <span>
+#include <thread>
+#include <utility> // for std::move
+#include <vector>
+
+// Parallel product of many complex numbers, reproducible whatever the
+// number of threads : the numbers are cut into leaves of a fixed size,
+// each leaf is reduced sequentially, by any thread, then the leaf results
+// are combined along a fixed binary tree.
+//
+// The polar mode sums the logarithms of the norms and the angles instead
+// of multiplying, with std::abs, which does not square the parts. Its leaf
+// loops call std::log and std::atan2 for each number, and are not
+// vectorized, unless with -ffast-math, which allows the reordering of
+// the sums, and a vector math library such as the libmvec of glibc.
+
+namespace product
+ {
+
+  constexpr std::size_t leaf_size {4096} ;
+
+  // combine the results of the leaves along the fixed binary tree
+  template< typename T, typename Combine >
+  T combine_leaves( std::vector<T> partials, Combine combine )
+   {
+    for ( std::size_t width=1 ; width<partials.size() ; width*=2 )
+      for ( std::size_t k=0 ; k+width<partials.size() ; k+=2*width )
+        partials[k] = combine(partials[k],partials[k+width]) ;
+    return partials[0] ;
+   }
+
+  // leaf(begin,end) reduces the indices [begin,end) of [0,size),
+  // and combine(lhs,rhs) merges two consecutive results
+  template< typename T, typename Leaf, typename Combine >
+  T tree_reduce( std::size_t size, std::size_t nb_threads, T identity, Leaf leaf, Combine combine )
+   {
+    std::size_t nb_leaves {(size+leaf_size-1)/leaf_size} ;
+    if (nb_leaves==0) return identity ;
+    std::vector<T> partials(nb_leaves,identity) ;
+    auto reduce_leaves = [&]( std::size_t first, std::size_t last )
+     {
+      for ( std::size_t k=first ; k<last ; ++k )
+        partials[k] = leaf(k*leaf_size,std::min((k+1)*leaf_size,size)) ;
+     } ;
+    if (nb_threads<=1) reduce_leaves(0,nb_leaves) ;
+    else
+     {
+      Partitioner partitioner(nb_leaves,nb_threads,Schedule::block) ;
+      std::vector<std::thread> workers ;
+      for ( std::size_t num=0 ; num<nb_threads ; ++num )
+        workers.emplace_back([&,num]{ partitioner.run(num,reduce_leaves) ; }) ;
+      for ( auto & worker : workers )
+       { worker.join() ; }
+     }
+    return combine_leaves(std::move(partials),combine) ;
+   }
+
+  template< typename Real >
+  std::complex<Real> cartesian_leaf( std::span<std::complex<Real> const> cs, std::size_t begin, std::size_t end )
+   {
+    std::complex<Real> prod {1.,0.} ;
+    for ( std::size_t i=begin ; i<end ; ++i ) prod *= cs[i] ;
+    return prod ;
+   }
+
+  template< typename Real >
+  std::complex<Real> multiply( std::complex<Real> lhs, std::complex<Real> rhs )
+   { return lhs*rhs ; }
+
+  template< typename Real >
+  std::complex<Real> cartesian( std::span<std::complex<Real> const> cs, std::size_t nb_threads = 1 )
+   {
+    return tree_reduce(cs.size(),nb_threads,std::complex<Real>{1.,0.},
+      [cs]( std::size_t begin, std::size_t end ){ return cartesian_leaf(cs,begin,end) ; },
+      multiply<Real>) ;
+   }
+
+  // same result as cartesian(cs), for numbers which are completed piece
+  // by piece, in any order and by any threads : each leaf is reduced by
+  // the thread which completes its last number, so that the result does
+  // not depend on how the numbers were cut into pieces
+  template< typename Real >
+  class Cartesian
+   {
+    public :
+
+      explicit Cartesian( std::span<std::complex<Real> const> cs )
+       : m_cs{cs}, m_partials((cs.size()+leaf_size-1)/leaf_size,{1.,0.}), m_missing(m_partials.size())
+       {
+        for ( std::size_t k=0 ; k<m_missing.size() ; ++k )
+          m_missing[k] = leaf_end(k)-k*leaf_size ;
+       }
+
+      // the numbers [begin,end) are final, and each number is completed once
+      void complete( std::size_t begin, std::size_t end )
+       {
+        for ( std::size_t k=begin/leaf_size ; (begin<end)&&(k*leaf_size<end) ; ++k )
+         {
+          std::size_t count {std::min(end,leaf_end(k))-std::max(begin,k*leaf_size)} ;
+          if (m_missing[k].fetch_sub(count)==count)
+            m_partials[k] = cartesian_leaf(m_cs,k*leaf_size,leaf_end(k)) ;
+         }
+       }
+
+      // when all the numbers are completed, and the completing threads joined
+      std::complex<Real> result() const
+       {
+        if (m_partials.empty()) return {1.,0.} ;
+        return combine_leaves(m_partials,multiply<Real>) ;
+       }
+
+    private :
+
+      std::size_t leaf_end( std::size_t k ) const
+       { return std::min((k+1)*leaf_size,m_cs.size()) ; }
+
+      std::span<std::complex<Real> const> m_cs ;
+      std::vector<std::complex<Real>> m_partials ;
+      std::vector<std::atomic<std::size_t>> m_missing ;
+   } ;
+
+  // product as the logarithm of its norm, and its angle, which is
+  // only the sum of the angles : reduce it to [-pi,pi] at the end
+  template< typename Real >
+  struct Polar
+   {
+    Real log_norm ;
+    Real angle ;
+   } ;
+
+  template< typename Real >
+  Polar<Real> polar( std::span<std::complex<Real> const> cs, std::size_t nb_threads = 1 )
+   {
+    return tree_reduce(cs.size(),nb_threads,Polar<Real>{0.,0.},
+      [cs]( std::size_t begin, std::size_t end )
+       {
+        Polar<Real> res {0.,0.} ;
+        for ( std::size_t i=begin ; i<end ; ++i )
+          res.log_norm += std::log(std::abs(cs[i])) ;
+        for ( std::size_t i=begin ; i<end ; ++i )
+          res.angle += std::atan2(cs[i].imag(),cs[i].real()) ;
+        return res ;
+       },
+      []( Polar<Real> lhs, Polar<Real> rhs )
+       { return Polar<Real>{lhs.log_norm+rhs.log_norm,lhs.angle+rhs.angle} ; }) ;
+   }
+
+ }
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include <condition_variable>
+#include <cstddef> // for std::size_t
+#include <deque>
+#include <exception> // for std::exception_ptr
+#include <mutex>
+#include <span>
+#include <utility> // for std::pair
+#include <vector>
+
+// Final buffer of some parallel computation, allocated once, and cut
+// into nb_slices slices : each producer task fills its slice in place,
+// through a span, and the consumer gets the slices in the order they
+// are completed, so that it can start working on the first ones while
+// the others are still computed.
+template< typename T >
+class ResultSink
+ {
+  public :
+
+    ResultSink( std::size_t size, std::size_t nb_slices )
+     : m_data(size), m_nb_slices{nb_slices} {}
+
+    std::size_t nb_slices() const { return m_nb_slices ; }
+
+    // indices [begin,end) of the slice num, whatever the size
+    std::pair<std::size_t,std::size_t> range( std::size_t num ) const
+     { return { num*m_data.size()/m_nb_slices, (num+1)*m_data.size()/m_nb_slices } ; }
+
+    std::span<T> slice( std::size_t num )
+     {
+      auto [begin,end] = range(num) ;
+      return { m_data.data()+begin, end-begin } ;
+     }
+
+    // producer side : call f(slice(num)), then mark the slice as done,
+    // even if f throws, in which case when_any() will rethrow
+    template< typename Function >
+    void fill( std::size_t num, Function f )
+     {
+      std::exception_ptr error ;
+      try { f(slice(num)) ; }
+      catch (...) { error = std::current_exception() ; }
+       {
+        std::scoped_lock<std::mutex> lock(m_mutex) ;
+        m_done.emplace_back(num,error) ;
+       }
+      m_completed.notify_one() ;
+     }
+
+    // consumer side : wait for the next completed slice, and return its
+    // number ; each slice is returned once, so call it nb_slices() times
+    std::size_t when_any()
+     {
+      std::unique_lock<std::mutex> lock(m_mutex) ;
+      m_completed.wait(lock,[this]{ return !m_done.empty() ; }) ;
+      auto [num,error] = m_done.front() ;
+      m_done.pop_front() ;
+      if (error) std::rethrow_exception(error) ;
+      return num ;
+     }
+
+    std::vector<T> & data() { return m_data ; }
+
+  private :
+
+    std::vector<T> m_data ;
+    std::size_t m_nb_slices ;
+    std::mutex m_mutex ;
+    std::condition_variable m_completed ;
+    std::deque<std::pair<std::size_t,std::exception_ptr>> m_done ;
+ } ;
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef SENDER_H
+#define SENDER_H
+
+#include "fifo-pool.h"
+#include "work-stealing.h"
+#include <condition_variable>
+#include <cstddef> // for std::size_t
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::invoke
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits> // for std::invoke_result_t & std::decay_t
+#include <utility> // for std::move, std::forward & std::exchange
+
+// A small subset of the senders and receivers of std::execution (P2300) :
+// - a sender describes some work, which will deliver values, or an error,
+//   to a receiver, through r.set_value(values...) or r.set_error(error) ;
+// - connect(sender,receiver) gives an operation, which does the work
+//   when start() is called ;
+// - a scheduler is a place where the work can run : schedule(scheduler)
+//   is a sender which completes in this place, and transfer(scheduler)
+//   moves the rest of a chain there ;
+// - then(f) calls f on the values of the previous sender, and sends its
+//   result, or the exception it has thrown, to the next receiver ;
+// - an AsyncScope starts senders without waiting for them, and join()
+//   waits until all of them are completed.
+// Senders are chained with operator|, as in :
+//   scope.spawn(just(n) | transfer(scheduler) | then(f) | then(g)) ;
+//
+// Unlike P2300, the operations do not need to stay alive until the end
+// of the work : each receiver is copied into the task given to the
+// scheduler, so receivers and values must be copyable, and set_value()
+// of the receivers given to spawn() must not throw.
+
+namespace sender
+ {
+
+  //=============================================
+  // schedulers
+  //=============================================
+
+  // runs the task right away, in the calling thread
+  struct InlineScheduler
+   {
+    template< typename Task >
+    void execute( Task task ) const { task() ; }
+   } ;
+
+  struct FifoScheduler
+   {
+    FifoPool * pool ;
+    template< typename Task >
+    void execute( Task task ) const { pool->execute(std::move(task)) ; }
+   } ;
+
+  struct WorkStealingScheduler
+   {
+    WorkStealingPool * pool ;
+    template< typename Task >
+    void execute( Task task ) const { pool->submit(std::move(task)) ; }
+   } ;
+
+  //=============================================
+  // senders
+  //=============================================
+
+  template< typename... Values >
+  struct Just
+   {
+    std::tuple<Values...> values ;
+
+    template< typename Receiver >
+    struct Operation
+     {
+      std::tuple<Values...> values ;
+      Receiver receiver ;
+      void start()
+       { std::apply([this]( Values &... vs ){ receiver.set_value(std::move(vs)...) ; },values) ; }
+     } ;
+
+    template< typename Receiver >
+    Operation<Receiver> connect( Receiver receiver ) &&
+     { return { std::move(values), std::move(receiver) } ; }
+   } ;
+
+  template< typename... Values >
+  Just<std::decay_t<Values>...> just( Values &&... values )
+   { return { { std::forward<Values>(values)... } } ; }
+
+  template< typename Scheduler >
+  struct Schedule
+   {
+    Scheduler scheduler ;
+
+    template< typename Receiver >
+    struct Operation
+     {
+      Scheduler scheduler ;
+      Receiver receiver ;
+      void start()
+       { scheduler.execute([receiver=receiver]() mutable { receiver.set_value() ; }) ; }
+     } ;
+
+    template< typename Receiver >
+    Operation<Receiver> connect( Receiver receiver ) &&
+     { return { scheduler, std::move(receiver) } ; }
+   } ;
+
+  template< typename Scheduler >
+  Schedule<Scheduler> schedule( Scheduler scheduler )
+   { return { scheduler } ; }
+
+  template< typename Sender, typename Function >
+  struct Then
+   {
+    Sender sender ;
+    Function f ;
+
+    template< typename Receiver >
+    struct ThenReceiver
+     {
+      Function f ;
+      Receiver next ;
+
+      template< typename... Values >
+      void set_value( Values &&... values )
+       {
+        using Result = std::invoke_result_t<Function,Values...> ;
+        if constexpr (std::is_void_v<Result>)
+         {
+          try { std::invoke(f,std::forward<Values>(values)...) ; }
+          catch (...) { next.set_error(std::current_exception()) ; return ; }
+          next.set_value() ;
+         }
+        else
+         {
+          // only the exceptions of f go to set_error, not the ones
+          // of the next receiver
+          std::optional<std::decay_t<Result>> result ;
+          try { result.emplace(std::invoke(f,std::forward<Values>(values)...)) ; }
+          catch (...) { next.set_error(std::current_exception()) ; return ; }
+          next.set_value(std::move(*result)) ;
+         }
+       }
+
+      void set_error( std::exception_ptr error ) { next.set_error(error) ; }
+     } ;
+
+    template< typename Receiver >
+    auto connect( Receiver receiver ) &&
+     { return std::move(sender).connect(ThenReceiver<Receiver>{std::move(f),std::move(receiver)}) ; }
+   } ;
+
+  template< typename Sender, typename Scheduler >
+  struct Transfer
+   {
+    Sender sender ;
+    Scheduler scheduler ;
+
+    template< typename Receiver >
+    struct TransferReceiver
+     {
+      Scheduler scheduler ;
+      Receiver next ;
+
+      template< typename... Values >
+      void set_value( Values &&... values )
+       {
+        scheduler.execute([next=next,values=std::tuple<std::decay_t<Values>...>(std::forward<Values>(values)...)]() mutable
+         { std::apply([&]( auto &... vs ){ next.set_value(std::move(vs)...) ; },values) ; }) ;
+       }
+
+      void set_error( std::exception_ptr error ) { next.set_error(error) ; }
+     } ;
+
+    template< typename Receiver >
+    auto connect( Receiver receiver ) &&
+     { return std::move(sender).connect(TransferReceiver<Receiver>{scheduler,std::move(receiver)}) ; }
+   } ;
+
+  //=============================================
+  // chaining with operator|
+  //=============================================
+
+  template< typename Function >
+  struct ThenClosure { Function f ; } ;
+
+  template< typename Function >
+  ThenClosure<Function> then( Function f )
+   { return { std::move(f) } ; }
+
+  template< typename Sender, typename Function >
+  Then<Sender,Function> operator|( Sender sender, ThenClosure<Function> closure )
+   { return { std::move(sender), std::move(closure.f) } ; }
+
+  template< typename Scheduler >
+  struct TransferClosure { Scheduler scheduler ; } ;
+
+  template< typename Scheduler >
+  TransferClosure<Scheduler> transfer( Scheduler scheduler )
+   { return { scheduler } ; }
+
+  template< typename Sender, typename Scheduler >
+  Transfer<Sender,Scheduler> operator|( Sender sender, TransferClosure<Scheduler> closure )
+   { return { std::move(sender), closure.scheduler } ; }
+
+  //=============================================
+  // waiting for the senders
+  //=============================================
+
+  class AsyncScope
+   {
+    public :
+
+      AsyncScope() = default ;
+      AsyncScope( AsyncScope const & ) = delete ;
+      AsyncScope & operator=( AsyncScope const & ) = delete ;
+      ~AsyncScope() { wait() ; }
+
+      // start the sender, ignoring its values
+      template< typename Sender >
+      void spawn( Sender sender )
+       {
+         {
+          std::scoped_lock<std::mutex> lock(m_mutex) ;
+          ++m_pending ;
+         }
+        auto operation {std::move(sender).connect(Receiver{this})} ;
+        operation.start() ;
+       }
+
+      // wait for all the spawned senders, then rethrow
+      // the first error they have sent, if any
+      void join()
+       {
+        wait() ;
+        std::exception_ptr error {std::exchange(m_error,nullptr)} ;
+        if (error) std::rethrow_exception(error) ;
+       }
+
+    private :
+
+      struct Receiver
+       {
+        AsyncScope * scope ;
+        template< typename... Values >
+        void set_value( Values &&... ) { scope->done(nullptr) ; }
+        void set_error( std::exception_ptr error ) { scope->done(error) ; }
+       } ;
+
+      void done( std::exception_ptr error )
+       {
+        std::scoped_lock<std::mutex> lock(m_mutex) ;
+        if (error && !m_error) m_error = error ;
+        if (--m_pending==0) m_empty.notify_all() ;
+       }
+
+      void wait()
+       {
+        std::unique_lock<std::mutex> lock(m_mutex) ;
+        m_empty.wait(lock,[this]{ return m_pending==0 ; }) ;
+       }
+
+      std::mutex m_mutex ;
+      std::condition_variable m_empty ;
+      std::size_t m_pending {0} ;
+      std::exception_ptr m_error ;
+   } ;
+
+  // start the sender and wait for its completion
+  template< typename Sender >
+  void sync_wait( Sender sender )
+   {
+    AsyncScope scope ;
+    scope.spawn(std::move(sender)) ;
+    scope.join() ;
+   }
+
+ }
+
+#endif
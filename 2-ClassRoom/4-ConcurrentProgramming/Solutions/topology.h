@@ -0,0 +1,226 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <algorithm> // for std::sort, std::find & std::max
+#include <cstddef> // for std::size_t
+#include <cstring> // for std::strerror
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <ostream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility> // for std::pair
+#include <vector>
+
+// Where the threads may run, as described by Linux in /sys :
+// - each cpu is a hardware thread, which belongs to a core, a package
+//   (socket) and a NUMA node ;
+// - the cpus of a core are SMT siblings, which share all its resources ;
+// - the caches of each level are shared by some group of cpus.
+// When /sys cannot be read, each cpu is assumed to be a core on its own.
+//
+// How the threads are then placed on the cpus :
+// - none : the threads are not pinned, the system moves them at will ;
+// - compact : the threads fill the siblings of a core, then the next core
+//   of the same node, so that neighbour threads share their caches ;
+// - scatter : the threads are dealt in turn to each node, and within a
+//   node to each core, so that they get the most memory bandwidth ;
+// - one-per-core : as compact, but only one thread per core, the second
+//   siblings being used only when there are more threads than cores.
+// When there are more threads than cpus, the placement wraps around.
+enum class Pinning { none, compact, scatter, one_per_core } ;
+
+inline Pinning select_pinning( std::string_view name )
+ {
+  if (name=="none") return Pinning::none ;
+  if (name=="compact") return Pinning::compact ;
+  if (name=="scatter") return Pinning::scatter ;
+  if (name=="one-per-core") return Pinning::one_per_core ;
+  throw std::runtime_error("unknown pinning: "+std::string(name)) ;
+ }
+
+class Topology
+ {
+  public :
+
+    struct Cpu
+     {
+      unsigned id ;
+      unsigned core ;    // index in cores()
+      unsigned sibling ; // rank among the cpus of its core
+      unsigned package ;
+      unsigned node ;
+     } ;
+
+    explicit Topology( std::filesystem::path const & root = "/sys/devices/system" )
+     {
+      for ( unsigned id : read_list(root/"cpu"/"online") )
+        m_cpus.push_back({id,0,0,read_number(cpu_path(root,id)/"topology"/"physical_package_id"),0}) ;
+      if (m_cpus.empty())
+        for ( unsigned id=0 ; id<std::max(std::thread::hardware_concurrency(),1u) ; ++id )
+          m_cpus.push_back({id,0,0,0,0}) ;
+
+      // numa nodes
+      for ( unsigned node : read_list(root/"node"/"online") )
+       {
+        std::vector<unsigned> ids ;
+        for ( unsigned id : read_list(root/"node"/("node"+std::to_string(node))/"cpulist") )
+          if (Cpu * cpu = find(id)) { cpu->node = m_nodes.size() ; ids.push_back(id) ; }
+        if (!ids.empty()) m_nodes.push_back(ids) ;
+       }
+      if (m_nodes.empty())
+       {
+        m_nodes.emplace_back() ;
+        for ( auto const & cpu : m_cpus ) m_nodes[0].push_back(cpu.id) ;
+       }
+
+      // cores, each one being identified by the list of its siblings
+      for ( auto & cpu : m_cpus )
+       {
+        std::vector<unsigned> siblings {read_list(cpu_path(root,cpu.id)/"topology"/"thread_siblings_list")} ;
+        if (siblings.empty()) siblings.push_back(cpu.id) ;
+        auto core {std::find(m_cores.begin(),m_cores.end(),siblings)} ;
+        cpu.core = core-m_cores.begin() ;
+        if (core==m_cores.end()) m_cores.push_back(siblings) ;
+        cpu.sibling = std::find(siblings.begin(),siblings.end(),cpu.id)-siblings.begin() ;
+       }
+
+      // caches shared by groups of cpus, the instruction ones excepted
+      for ( auto const & cpu : m_cpus )
+        for ( unsigned index=0 ; ; ++index )
+         {
+          auto cache {cpu_path(root,cpu.id)/"cache"/("index"+std::to_string(index))} ;
+          if (!std::filesystem::exists(cache)) break ;
+          if (read_line(cache/"type")=="Instruction") continue ;
+          auto & groups {m_caches[read_number(cache/"level")]} ;
+          std::vector<unsigned> ids {read_list(cache/"shared_cpu_list")} ;
+          if (std::find(groups.begin(),groups.end(),ids)==groups.end()) groups.push_back(ids) ;
+         }
+     }
+
+    std::vector<Cpu> const & cpus() const { return m_cpus ; }
+
+    // the cpus of each core, of each numa node
+    std::vector<std::vector<unsigned>> const & cores() const { return m_cores ; }
+    std::vector<std::vector<unsigned>> const & nodes() const { return m_nodes ; }
+
+    // the groups of cpus sharing a cache of the given level
+    std::vector<std::vector<unsigned>> caches( unsigned level ) const
+     {
+      auto found {m_caches.find(level)} ;
+      return (found==m_caches.end())?std::vector<std::vector<unsigned>>{}:found->second ;
+     }
+
+    // the cpu of each of the nb_threads, empty for Pinning::none
+    std::vector<unsigned> placement( Pinning pinning, std::size_t nb_threads ) const
+     {
+      if ((pinning==Pinning::none)||(nb_threads==0)) return {} ;
+      std::vector<Cpu> order {m_cpus} ;
+      std::sort(order.begin(),order.end(),[]( Cpu const & c1, Cpu const & c2 )
+       { return std::tie(c1.node,c1.package,c1.core,c1.sibling)<std::tie(c2.node,c2.package,c2.core,c2.sibling) ; }) ;
+
+      // sort keys, ending with the index in the compact order ; for scatter,
+      // the rank of a cpu among the ones of its node with the same sibling rank
+      std::vector<std::tuple<std::size_t,std::size_t,std::size_t,std::size_t>> keys ;
+      std::map<std::pair<unsigned,unsigned>,std::size_t> ranks ;
+      for ( std::size_t i=0 ; i<order.size() ; ++i )
+       {
+        Cpu const & cpu {order[i]} ;
+        std::size_t rank {ranks[{cpu.node,cpu.sibling}]++} ;
+        switch (pinning)
+         {
+          case Pinning::scatter : keys.emplace_back(cpu.sibling,rank,cpu.node,i) ; break ;
+          case Pinning::one_per_core : keys.emplace_back(cpu.sibling,i,0,i) ; break ;
+          default : keys.emplace_back(i,0,0,i) ;
+         }
+       }
+      std::sort(keys.begin(),keys.end()) ;
+      std::vector<unsigned> res(nb_threads) ;
+      for ( std::size_t num=0 ; num<nb_threads ; ++num )
+        res[num] = order[std::get<3>(keys[num%keys.size()])].id ;
+      return res ;
+     }
+
+    void report( std::ostream & os ) const
+     {
+      os<<"(topology: "<<m_cpus.size()<<" cpus, "<<m_cores.size()<<" cores, "
+        <<m_nodes.size()<<" numa nodes" ;
+      for ( auto const & [level,groups] : m_caches )
+        os<<", "<<groups.size()<<" L"<<level ;
+      os<<")\n" ;
+     }
+
+  private :
+
+    static std::filesystem::path cpu_path( std::filesystem::path const & root, unsigned id )
+     { return root/"cpu"/("cpu"+std::to_string(id)) ; }
+
+    static std::string read_line( std::filesystem::path const & path )
+     {
+      std::ifstream file(path) ;
+      std::string line ;
+      std::getline(file,line) ;
+      return line ;
+     }
+
+    static unsigned read_number( std::filesystem::path const & path )
+     {
+      std::string line {read_line(path)} ;
+      return line.empty()?0:std::stoul(line) ;
+     }
+
+    // a list such as "0-3,8-11"
+    static std::vector<unsigned> read_list( std::filesystem::path const & path )
+     {
+      std::vector<unsigned> res ;
+      std::istringstream line(read_line(path)) ;
+      std::string range ;
+      while (std::getline(line,range,','))
+       {
+        if (range.empty()) continue ;
+        std::size_t dash {range.find('-')} ;
+        unsigned first = std::stoul(range.substr(0,dash)) ;
+        unsigned last = (dash==std::string::npos)?first:std::stoul(range.substr(dash+1)) ;
+        for ( unsigned id=first ; id<=last ; ++id ) res.push_back(id) ;
+       }
+      return res ;
+     }
+
+    Cpu * find( unsigned id )
+     {
+      for ( auto & cpu : m_cpus )
+        if (cpu.id==id) return &cpu ;
+      return nullptr ;
+     }
+
+    std::vector<Cpu> m_cpus ;
+    std::vector<std::vector<unsigned>> m_cores ;
+    std::vector<std::vector<unsigned>> m_nodes ;
+    std::map<unsigned,std::vector<std::vector<unsigned>>> m_caches ;
+ } ;
+
+// restrict the calling thread to a single cpu : each thread pins itself
+// when it starts, before it first touches its data, so that its pages are
+// allocated on the NUMA node of the cpu ; a failure, for example because
+// the cpu is not allowed to this process, is reported on std::cerr in a
+// single write, since several threads may fail together, and the thread
+// goes on unpinned
+inline void pin_current( unsigned cpu )
+ {
+  cpu_set_t set ;
+  CPU_ZERO(&set) ;
+  CPU_SET(cpu,&set) ;
+  int error {pthread_setaffinity_np(pthread_self(),sizeof(set),&set)} ;
+  if (error!=0)
+    std::cerr<<("(cannot pin a thread on cpu "+std::to_string(cpu)+": "+std::strerror(error)+")\n") ;
+ }
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // for std::size_t
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory> // for std::make_shared
+#include <mutex>
+#include <thread>
+#include <type_traits> // for std::invoke_result_t
+#include <vector>
+
+// Persistent pool of threads, each one with its own deque of tasks :
+// - a task submitted from a worker goes into the deque of this worker,
+//   and one submitted from outside is distributed round-robin ;
+// - a worker takes its own tasks from the back (the most recent, still
+//   in cache), and when it has none, steals from the front of the others ;
+// - submit() returns a std::future, as std::async, but no thread is
+//   created per task, and the arguments are not copied.
+class WorkStealingPool
+ {
+  public :
+
+    // each worker num starts with on_start(num), if given,
+    // for example to pin itself to some cpu
+    explicit WorkStealingPool( std::size_t nb_workers = std::thread::hardware_concurrency(),
+                               std::function<void( std::size_t )> on_start = {} )
+     : m_queues(nb_workers>0?nb_workers:1)
+     {
+      for ( std::size_t num=0 ; num<m_queues.size() ; ++num )
+        m_workers.emplace_back(&WorkStealingPool::work,this,num,on_start) ;
+     }
+
+    WorkStealingPool( WorkStealingPool const & ) = delete ;
+    WorkStealingPool & operator=( WorkStealingPool const & ) = delete ;
+
+    // the remaining tasks are executed before the workers stop
+    ~WorkStealingPool()
+     {
+       {
+        std::scoped_lock<std::mutex> lock(m_mutex) ;
+        m_stop = true ;
+       }
+      m_wake.notify_all() ;
+      for ( auto & worker : m_workers )
+       { worker.join() ; }
+     }
+
+    std::size_t size() const { return m_workers.size() ; }
+
+    // true when called by one of the workers of this pool
+    bool is_worker() const { return t_pool==this ; }
+
+    template< typename Function >
+    std::future<std::invoke_result_t<Function>> submit( Function f )
+     {
+      using Result = std::invoke_result_t<Function> ;
+      auto task {std::make_shared<std::packaged_task<Result()>>(std::move(f))} ;
+      std::future<Result> res {task->get_future()} ;
+      std::size_t num {is_worker()?t_worker:(m_next++%m_queues.size())} ;
+       {
+        std::scoped_lock<std::mutex> lock(m_mutex) ;
+        ++m_queued ;
+       }
+       {
+        std::scoped_lock<std::mutex> lock(m_queues[num].mutex) ;
+        m_queues[num].tasks.emplace_back([task]{ (*task)() ; }) ;
+       }
+      m_wake.notify_one() ;
+      return res ;
+     }
+
+  private :
+
+    using Task = std::function<void()> ;
+
+    struct Queue
+     {
+      std::mutex mutex ;
+      std::deque<Task> tasks ;
+     } ;
+
+    bool pop( std::size_t num, Task & task )
+     {
+      std::scoped_lock<std::mutex> lock(m_queues[num].mutex) ;
+      if (m_queues[num].tasks.empty()) return false ;
+      task = std::move(m_queues[num].tasks.back()) ;
+      m_queues[num].tasks.pop_back() ;
+      return true ;
+     }
+
+    bool steal( std::size_t num, Task & task )
+     {
+      for ( std::size_t i=1 ; i<m_queues.size() ; ++i )
+       {
+        Queue & victim {m_queues[(num+i)%m_queues.size()]} ;
+        std::scoped_lock<std::mutex> lock(victim.mutex) ;
+        if (victim.tasks.empty()) continue ;
+        task = std::move(victim.tasks.front()) ;
+        victim.tasks.pop_front() ;
+        return true ;
+       }
+      return false ;
+     }
+
+    void work( std::size_t num, std::function<void( std::size_t )> on_start )
+     {
+      if (on_start) on_start(num) ;
+      t_pool = this ;
+      t_worker = num ;
+      while (true)
+       {
+        Task task ;
+        if (pop(num,task)||steal(num,task))
+         {
+          --m_queued ;
+          task() ;
+          continue ;
+         }
+        std::unique_lock<std::mutex> lock(m_mutex) ;
+        m_wake.wait(lock,[this]{ return m_stop || (m_queued>0) ; }) ;
+        if (m_stop && (m_queued==0)) return ;
+       }
+     }
+
+    std::vector<Queue> m_queues ;
+    std::vector<std::thread> m_workers ;
+    std::mutex m_mutex ;
+    std::condition_variable m_wake ;
+    std::atomic<std::size_t> m_queued {0} ;
+    std::atomic<std::size_t> m_next {0} ;
+    bool m_stop {false} ;
+
+    static inline thread_local WorkStealingPool * t_pool {nullptr} ;
+    static inline thread_local std::size_t t_worker {0} ;
+ } ;
+
+#endif
@@ -10,7 +10,7 @@ SRC_FILE = sys.argv[2]
 RUN_ARGS = ' '.join(sys.argv[3:])
 
 exe_file = SRC_FILE.replace(".cpp",".exe")
-compile_cmd = "rm -f {} && g++ -std=c++17 -O3 -march=native {} -o {}".format(exe_file,SRC_FILE,exe_file)
+compile_cmd = "rm -f {} && g++ -std=c++20 -O3 -march=native {} -o {}".format(exe_file,SRC_FILE,exe_file)
 run_cmd = "./{} {}".format(exe_file,RUN_ARGS)
 
 # Utility fonction
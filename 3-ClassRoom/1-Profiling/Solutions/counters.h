@@ -0,0 +1,137 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <array>
+#include <cerrno>
+#include <cstddef> // for std::size_t
+#include <cstdint>
+#include <cstring> // for std::strerror
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters of the calling thread, with the Linux perf_event_open
+// system call : cycles, instructions, cache and branch misses, and on
+// Intel, the floating point operations by vector width.
+//
+// Each event is opened on its own, so that one which is not supported
+// does not prevent the others, and so that the kernel can multiplex them
+// when there are more events than hardware counters : the values are then
+// extrapolated from the fraction of the time each one was counted.
+//
+// In containers, or when /proc/sys/kernel/perf_event_paranoid forbids it,
+// the events cannot be opened : available() is then false, and read()
+// gives zeros, so that the instrumented code runs unchanged.
+class Counters
+ {
+  public :
+
+    static constexpr std::size_t max_events {8} ;
+    using Values = std::array<std::uint64_t,max_events> ;
+
+    struct Event
+     {
+      char const * name ;
+      std::uint32_t type ;
+      std::uint64_t config ;
+      bool intel_only ;
+     } ;
+
+#ifdef __linux__
+    static constexpr std::array<Event,max_events> events
+     {{
+      { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, false },
+      { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, false },
+      { "l1d-misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D|(PERF_COUNT_HW_CACHE_OP_READ<<8)|(PERF_COUNT_HW_CACHE_RESULT_MISS<<16), false },
+      { "llc-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, false },
+      { "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, false },
+      // FP_ARITH_INST_RETIRED, single and double precision together
+      { "fp-scalar", PERF_TYPE_RAW, 0x03C7, true },
+      { "fp-128b", PERF_TYPE_RAW, 0x0CC7, true },
+      { "fp-256b", PERF_TYPE_RAW, 0x30C7, true }
+     }} ;
+#else
+    static constexpr std::array<Event,max_events> events {} ;
+#endif
+
+    Counters()
+     {
+      m_fds.fill(-1) ;
+#ifdef __linux__
+      bool intel {false} ;
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_cpu_init() ;
+      intel = __builtin_cpu_is("intel") ;
+#endif
+      for ( std::size_t num=0 ; num<max_events ; ++num )
+       {
+        if (events[num].intel_only && !intel) continue ;
+        perf_event_attr attr {} ;
+        attr.size = sizeof(attr) ;
+        attr.type = events[num].type ;
+        attr.config = events[num].config ;
+        attr.exclude_kernel = 1 ;
+        attr.exclude_hv = 1 ;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING ;
+        m_fds[num] = syscall(SYS_perf_event_open,&attr,0,-1,-1,0) ;
+        if ((m_fds[num]<0)&&m_error.empty())
+          m_error = std::string(events[num].name)+": "+std::strerror(errno) ;
+       }
+#else
+      m_error = "perf_event_open is specific to Linux" ;
+#endif
+     }
+
+    Counters( Counters const & ) = delete ;
+    Counters & operator=( Counters const & ) = delete ;
+
+    ~Counters()
+     {
+#ifdef __linux__
+      for ( int fd : m_fds )
+        if (fd>=0) close(fd) ;
+#endif
+     }
+
+    bool available( std::size_t num ) const { return m_fds[num]>=0 ; }
+    bool available() const { return mask()!=0 ; }
+
+    // bit num is set if the event num is available
+    unsigned mask() const
+     {
+      unsigned res {0} ;
+      for ( std::size_t num=0 ; num<max_events ; ++num )
+        if (available(num)) res |= 1u<<num ;
+      return res ;
+     }
+
+    // why the first event which failed could not be opened
+    std::string const & error() const { return m_error ; }
+
+    // current values, since the creation of the counters
+    void read( Values & values ) const
+     {
+      values.fill(0) ;
+#ifdef __linux__
+      for ( std::size_t num=0 ; num<max_events ; ++num )
+       {
+        if (!available(num)) continue ;
+        std::uint64_t data[3] ; // value, time enabled, time running
+        if (::read(m_fds[num],data,sizeof(data))!=sizeof(data)) continue ;
+        if (data[2]==0) continue ;
+        values[num] = (data[2]<data[1])?static_cast<std::uint64_t>(double(data[0])*data[1]/data[2]):data[0] ;
+       }
+#endif
+     }
+
+  private :
+
+    std::array<int,max_events> m_fds ;
+    std::string m_error ;
+ } ;
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "counters.h"
+#include <algorithm> // for std::min & std::max
+#include <array>
+#include <atomic>
+#include <bit> // for std::bit_width
+#include <chrono>
+#include <cstddef> // for std::size_t
+#include <cstdint>
+#include <iomanip> // for std::setprecision
+#include <limits>
+#include <memory> // for std::unique_ptr
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility> // for std::forward
+#include <vector>
+
+// Instrumentation by scoped zones :
+//   profiler::Zone zone {"name"} ;
+// measures the time until the end of the enclosing scope. The zones
+// opened while another one is alive become its children, so that each
+// thread builds a tree of zones, identified by their path of names.
+//
+// Each node of the tree aggregates the durations of its zone : count,
+// total, min, max, and a histogram with four buckets per power of two,
+// which gives the percentiles within 25 %. The trees are thread local,
+// so a zone only costs two clock reads and a short search among the
+// children of the current node, and never takes a lock.
+//
+// After enable_counters(), the zones also accumulate the hardware
+// counters of counters.h. Each zone then costs a few system calls, that
+// is a few microseconds : keep it for zones much longer than that.
+//
+// report() merges the trees of all the threads, by path, and prints
+// them : call it when the instrumented threads are done. The names
+// are not copied, and must live until then, as string literals do.
+
+namespace profiler
+ {
+
+  constexpr std::size_t nb_buckets {252} ;
+
+  // four buckets per power of two, exact below 4 ns
+  inline std::size_t bucket( std::uint64_t ns )
+   {
+    if (ns<4) return ns ;
+    std::size_t width = std::bit_width(ns) ;
+    return (width-2)*4+((ns>>(width-3))&3) ;
+   }
+
+  // middle of the bucket
+  inline double bucket_value( std::size_t num )
+   {
+    if (num<4) return num ;
+    std::size_t width {num/4+2} ;
+    double step = std::uint64_t{1}<<(width-3) ;
+    return (4+num%4)*step+step/2 ;
+   }
+
+  struct Node
+   {
+    std::string_view name ;
+    Node * parent {nullptr} ;
+    std::vector<std::unique_ptr<Node>> children ;
+    std::uint64_t count {0} ;
+    std::uint64_t total {0} ;
+    std::uint64_t min {std::numeric_limits<std::uint64_t>::max()} ;
+    std::uint64_t max {0} ;
+    std::array<std::uint64_t,nb_buckets> histogram {} ;
+    std::uint64_t counted {0} ;
+    Counters::Values events {} ;
+
+    Node * child( std::string_view child_name )
+     {
+      for ( auto & node : children )
+        if (node->name==child_name) return node.get() ;
+      children.push_back(std::make_unique<Node>()) ;
+      children.back()->name = child_name ;
+      children.back()->parent = this ;
+      return children.back().get() ;
+     }
+
+    void record( std::uint64_t ns )
+     {
+      ++count ;
+      total += ns ;
+      min = std::min(min,ns) ;
+      max = std::max(max,ns) ;
+      ++histogram[bucket(ns)] ;
+     }
+
+    void record( Counters::Values const & deltas )
+     {
+      ++counted ;
+      for ( std::size_t num=0 ; num<Counters::max_events ; ++num )
+        events[num] += deltas[num] ;
+     }
+
+    void merge( Node const & other )
+     {
+      count += other.count ;
+      total += other.total ;
+      min = std::min(min,other.min) ;
+      max = std::max(max,other.max) ;
+      for ( std::size_t num=0 ; num<nb_buckets ; ++num )
+        histogram[num] += other.histogram[num] ;
+      counted += other.counted ;
+      for ( std::size_t num=0 ; num<Counters::max_events ; ++num )
+        events[num] += other.events[num] ;
+      for ( auto const & node : other.children )
+        child(node->name)->merge(*node) ;
+     }
+
+    // estimated duration below which are the given fraction of the calls
+    double percentile( double fraction ) const
+     {
+      std::uint64_t rank = fraction*(count-1) ;
+      std::uint64_t seen {0} ;
+      for ( std::size_t num=0 ; num<nb_buckets ; ++num )
+        if ((seen+=histogram[num])>rank)
+          return std::clamp(bucket_value(num),double(min),double(max)) ;
+      return max ;
+     }
+   } ;
+
+  struct Tree
+   {
+    Node root ;
+    Node * current {&root} ;
+   } ;
+
+  // the trees of all the threads, kept after the end of the threads
+  inline std::mutex registry_mutex ;
+  inline std::vector<std::unique_ptr<Tree>> registry ;
+
+  // hardware counters : if enabled, whether each event could be
+  // opened by at least one thread, or else why not
+  inline std::atomic<bool> counting {false} ;
+  inline unsigned counters_mask {0} ;
+  inline std::string counters_error ;
+
+  // the tree of the calling thread, registered at its first zone
+  inline Tree & local_tree()
+   {
+    thread_local Tree * tree {nullptr} ;
+    if (!tree)
+     {
+      std::scoped_lock<std::mutex> lock(registry_mutex) ;
+      registry.push_back(std::make_unique<Tree>()) ;
+      tree = registry.back().get() ;
+     }
+    return *tree ;
+   }
+
+  // the counters of the calling thread, opened at its first zone, and
+  // closed at its exit : unlike the tree, they are not kept, since their
+  // counts are already accumulated in the nodes
+  inline Counters & local_counters()
+   {
+    thread_local std::unique_ptr<Counters> counters ;
+    if (!counters)
+     {
+      counters = std::make_unique<Counters>() ;
+      std::scoped_lock<std::mutex> lock(registry_mutex) ;
+      counters_mask |= counters->mask() ;
+      if (counters_error.empty()) counters_error = counters->error() ;
+     }
+    return *counters ;
+   }
+
+  // the counters of the calling thread are opened right away,
+  // the ones of the other threads at their first zone
+  inline void enable_counters( bool on = true )
+   {
+    counting = on ;
+    if (on) local_counters() ;
+   }
+
+  class Zone
+   {
+    public :
+
+      explicit Zone( std::string_view name )
+       : m_tree{local_tree()}, m_node{m_tree.current->child(name)}
+       {
+        m_tree.current = m_node ;
+        if (counting.load(std::memory_order_relaxed))
+         {
+          m_counters = &local_counters() ;
+          m_counters->read(m_counts) ;
+         }
+        m_start = std::chrono::steady_clock::now() ;
+       }
+
+      Zone( Zone const & ) = delete ;
+      Zone & operator=( Zone const & ) = delete ;
+
+      ~Zone()
+       { if (m_node) stop() ; }
+
+      // end the zone before its destruction, for example to display
+      // its duration, which is returned, outside of the zone
+      std::chrono::nanoseconds stop()
+       {
+        auto end {std::chrono::steady_clock::now()} ;
+        if (m_counters)
+         {
+          Counters::Values counts ;
+          m_counters->read(counts) ;
+          for ( std::size_t num=0 ; num<Counters::max_events ; ++num )
+            counts[num] = (counts[num]>m_counts[num])?counts[num]-m_counts[num]:0 ;
+          m_node->record(counts) ;
+         }
+        auto duration {std::chrono::duration_cast<std::chrono::nanoseconds>(end-m_start)} ;
+        m_node->record(duration.count()) ;
+        m_tree.current = m_node->parent ;
+        m_node = nullptr ;
+        return duration ;
+       }
+
+    private :
+
+      Tree & m_tree ;
+      Node * m_node ;
+      std::chrono::steady_clock::time_point m_start ;
+      Counters * m_counters {nullptr} ;
+      Counters::Values m_counts ;
+   } ;
+
+  // call f(args...) within a zone
+  template< typename Function, typename... ArgTypes >
+  decltype(auto) zone( std::string_view name, Function && f, ArgTypes &&... args )
+   {
+    Zone zone {name} ;
+    return std::forward<Function>(f)(std::forward<ArgTypes>(args)...) ;
+   }
+
+  inline void print( std::ostream & os, Node const & node, std::size_t depth )
+   {
+    auto us = []( double ns ){ return ns/1000. ; } ;
+    os<<"("<<std::string(2*depth,' ')<<node.name ;
+    // a zone still alive, such as one around the call to report()
+    if (node.count==0) os<<" not completed)\n" ;
+    else os<<" calls: "<<node.count
+      <<", total: "<<us(node.total)<<" us"
+      <<", mean: "<<us(double(node.total)/node.count)
+      <<", min: "<<us(node.min)
+      <<", p50: "<<us(node.percentile(0.50))
+      <<", p99: "<<us(node.percentile(0.99))
+      <<", max: "<<us(node.max)<<" us)\n" ;
+
+    // mean counts per call, and instructions per cycle
+    if ((node.counted>0)&&(counters_mask!=0))
+     {
+      os<<"("<<std::string(2*depth,' ')<<node.name<<" per call" ;
+      for ( std::size_t num=0 ; num<Counters::max_events ; ++num )
+        if (counters_mask&(1u<<num))
+          os<<", "<<Counters::events[num].name<<": "<<node.events[num]/node.counted ;
+      if ((counters_mask&3)==3 && (node.events[0]>0))
+        os<<", ipc: "<<double(node.events[1])/node.events[0] ;
+      os<<")\n" ;
+     }
+    for ( auto const & child : node.children )
+      print(os,*child,depth+1) ;
+   }
+
+  // merge the trees of all the threads, and print the zones
+  inline void report( std::ostream & os )
+   {
+    Node all ;
+    auto flags {os.flags()} ;
+    auto precision {os.precision()} ;
+    os<<std::fixed<<std::setprecision(3) ;
+     {
+      std::scoped_lock<std::mutex> lock(registry_mutex) ;
+      for ( auto const & tree : registry )
+        all.merge(tree->root) ;
+     }
+    if (counting && (counters_mask==0))
+      os<<"(counters unavailable: "<<counters_error<<")\n" ;
+    for ( auto const & node : all.children )
+      print(os,*node,0) ;
+    os.flags(flags) ;
+    os.precision(precision) ;
+   }
+
+ }
+
+#endif
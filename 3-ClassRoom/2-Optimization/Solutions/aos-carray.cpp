@@ -1,7 +1,12 @@
+#include "simd-kernels.h"
+#include "arrays-options.h"
+#include "tiling.h"
 #include <iostream>
 #include <cassert> // for assert
 #include <cstdlib> // for rand & atoi
 #include <format>
+#include <iterator> // for std::contiguous_iterator
+#include <memory> // for std::to_address
 
 struct XY
  {
@@ -34,11 +39,25 @@ double accumulate_y( Itr begin, Itr end )
   return res ;
  }
 
+// explicitly vectorized variants, for a contiguous collection
+// whose elements are seen as interleaved {x,y} pairs of doubles
+
+static_assert(sizeof(XY)==2*sizeof(double)) ;
+
+template< std::contiguous_iterator Itr >
+void saxpy( simd::Kernels const & kernels, Itr begin, Itr end, double a )
+ { kernels.saxpy_xy(end-begin,a,&std::to_address(begin)->x) ; }
+
+template< std::contiguous_iterator Itr >
+double accumulate_y( simd::Kernels const & kernels, Itr begin, Itr end )
+ { return kernels.sum_y(end-begin,&std::to_address(begin)->x) ; }
+
 int main( int argc, char * argv[] )
  {
-  assert(argc==3) ;
+  assert(argc>=3) ;
   std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
   std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
 
   XY * collection {new XY[size]} ;
   auto begin {collection} ;
@@ -46,9 +65,12 @@ int main( int argc, char * argv[] )
 
   randomize_x(begin,end) ;
   double volatile a {0.1} ;
-  while (repeat--)
-    saxpy(begin,end,a) ;
-  double res {accumulate_y(begin,end)/size} ;
+  double res {with_kernels(argc,argv,[&]( auto const & ... kernels )
+   {
+    repeat_saxpy(begin,end,tile,repeat,[&]( auto first, auto last )
+     { saxpy(kernels...,first,last,a) ; }) ;
+    return accumulate_y(kernels...,begin,end)/size ;
+   })} ;
   std::cout<<res<<std::endl ;
 
   delete [] collection ;
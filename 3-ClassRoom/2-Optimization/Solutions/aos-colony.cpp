@@ -0,0 +1,61 @@
+#include "colony.h"
+#include "arrays-options.h"
+#include "tiling.h"
+#include <iostream>
+#include <cassert> // for assert
+#include <cstdlib> // for rand
+#include <format>
+
+struct XY
+ {
+  double x, y {0.} ;
+  void saxpy( double a )
+   { y = a*x + y ; }
+ } ;
+
+template< typename Itr >
+void randomize_x( Itr begin, Itr end )
+ {
+  srand(1) ;
+  for ( ; begin!=end ; ++begin )
+   { begin->x = std::rand()/(RAND_MAX+1.)-0.5 ; }
+ }
+
+// one contiguous run of elements after the other, rather than with the
+// iterators, which check each slot
+void saxpy( Colony<XY> & collection, std::size_t begin, std::size_t end, double a )
+ {
+  collection.for_each_block(begin,end,[a]( XY * xys, std::size_t count )
+   {
+    for ( std::size_t i=0 ; i<count ; ++i )
+      xys[i].saxpy(a) ;
+   }) ;
+ }
+
+double accumulate_y( Colony<XY> const & collection )
+ {
+  double res {0.} ;
+  collection.for_each_block([&res]( XY const * xys, std::size_t count )
+   {
+    for ( std::size_t i=0 ; i<count ; ++i )
+      res += xys[i].y ;
+   }) ;
+  return res ;
+ }
+
+int main( int argc, char * argv[] )
+ {
+  assert(argc>=3) ;
+  std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
+  std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  reject_kernels(argc,argv) ;
+
+  Colony<XY> collection(size) ;
+  randomize_x(std::begin(collection),std::end(collection)) ;
+  double volatile a {0.1} ;
+  repeat_saxpy(std::size_t{0},collection.slots(),tile,repeat,
+    [&]( std::size_t first, std::size_t last ){ saxpy(collection,first,last,a) ; }) ;
+  double res {accumulate_y(collection)/size} ;
+  std::cout<<std::format("{}",res)<<std::endl ;
+ }
@@ -1,7 +1,14 @@
+#include "simd-kernels.h"
+#include "arrays-options.h"
+#include "tiling.h"
+#include "huge-pages.h"
 #include <iostream>
 #include <cassert> // for assert
 #include <cstdlib> // for rand & atoi
 #include <format>
+#include <iterator> // for std::contiguous_iterator
+#include <memory> // for std::to_address & std::uninitialized_default_construct_n
+#include <memory_resource>
 
 struct XY
  {
@@ -34,36 +41,92 @@ double accumulate_y( Itr begin, Itr end )
   return res ;
  }
 
+// explicitly vectorized variants, for a contiguous collection
+// whose elements are seen as interleaved {x,y} pairs of doubles
+
+static_assert(sizeof(XY)==2*sizeof(double)) ;
+
+template< std::contiguous_iterator Itr >
+void saxpy( simd::Kernels const & kernels, Itr begin, Itr end, double a )
+ { kernels.saxpy_xy(end-begin,a,&std::to_address(begin)->x) ; }
+
+template< std::contiguous_iterator Itr >
+double accumulate_y( simd::Kernels const & kernels, Itr begin, Itr end )
+ { return kernels.sum_y(end-begin,&std::to_address(begin)->x) ; }
+
+// the memory comes from a pluggable memory resource, new/delete by default
 template< typename T >
 class DynArray
  {
   public :
-    explicit DynArray( std::size_t size ) : m_size{size}, m_data{new T [size]} {}
+    explicit DynArray( std::size_t size, std::pmr::polymorphic_allocator<T> allocator = {} )
+     : m_size{size}, m_allocator{allocator}, m_data{m_allocator.allocate(size)}
+     { std::uninitialized_default_construct_n(m_data,m_size) ; }
+    DynArray( DynArray const & ) = delete ;
+    DynArray & operator=( DynArray const & ) = delete ;
     T * begin() { return m_data ; }
     T * end() { return m_data+m_size ; }
     std::size_t size() { return m_size ; }
     T & operator[]( std::size_t indice ) { return m_data[indice] ; }
     T const & operator[]( std::size_t indice ) const { return m_data[indice] ; }
-    ~DynArray() { delete [] m_data ; }
+    ~DynArray()
+     {
+      std::destroy_n(m_data,m_size) ;
+      m_allocator.deallocate(m_data,m_size) ;
+     }
   private :
     std::size_t m_size ;
+    std::pmr::polymorphic_allocator<T> m_allocator ;
     T * m_data ;
  } ;
 
 int main( int argc, char * argv[] )
  {
-  assert(argc==3) ;
+  assert(argc>=3) ;
   std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
   std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  std::string_view alloc {option(argc,argv,"alloc","new")} ;
+  std::string_view pages {option(argc,argv,"pages","normal")} ;
+  std::size_t events {size_option(argc,argv,"events",1)} ;
 
-  DynArray<XY> collection(size) ;
-  auto begin {std::begin(collection)} ;
-  auto end {std::end(collection)} ;
+  // memory resources : huge pages or not, below a monotonic arena
+  // or a size-class pool ; the arena is given an initial buffer for
+  // one collection, which it reuses after each release
+  HugePageResource huge_pages ;
+  std::pmr::memory_resource * upstream {std::pmr::new_delete_resource()} ;
+  if (pages=="huge") upstream = &huge_pages ;
+  else if (pages!="normal") usage_error("unknown pages: "+std::string(pages),"--pages=normal|huge") ;
+  std::size_t arena_bytes {(alloc=="arena")?size*sizeof(XY)+alignof(XY):0} ;
+  void * arena_buffer {(arena_bytes>0)?upstream->allocate(arena_bytes):nullptr} ;
+  std::pmr::monotonic_buffer_resource arena(arena_buffer,arena_bytes,upstream) ;
+  std::pmr::unsynchronized_pool_resource pool(upstream) ;
+  std::pmr::memory_resource * resource {upstream} ;
+  if (alloc=="arena") resource = &arena ;
+  else if (alloc=="pool") resource = &pool ;
+  else if (alloc!="new") usage_error("unknown alloc: "+std::string(alloc),"--alloc=new|arena|pool") ;
 
-  randomize_x(begin,end) ;
+  // each event creates and destroys its own collection
   double volatile a {0.1} ;
-  while (repeat--)
-    saxpy(begin,end,a) ;
-  double res {accumulate_y(begin,end)/size} ;
+  double res {with_kernels(argc,argv,[&]( auto const & ... kernels )
+   {
+    double last {0.} ;
+    for ( std::size_t event=0 ; event<events ; ++event )
+     {
+       {
+        DynArray<XY> collection(size,resource) ;
+        auto begin {std::begin(collection)} ;
+        auto end {std::end(collection)} ;
+
+        randomize_x(begin,end) ;
+        repeat_saxpy(begin,end,tile,repeat,[&]( auto first, auto last )
+         { saxpy(kernels...,first,last,a) ; }) ;
+        last = accumulate_y(kernels...,begin,end)/size ;
+       }
+      arena.release() ;
+     }
+    return last ;
+   })} ;
+  if (arena_buffer!=nullptr) upstream->deallocate(arena_buffer,arena_bytes) ;
   std::cout<<std::format("{}",res)<<std::endl ;
  }
@@ -1,3 +1,5 @@
+#include "arrays-options.h"
+#include "tiling.h"
 #include <iostream>
 #include <cassert> // for assert
 #include <cstdlib> // for rand
@@ -37,9 +39,11 @@ double accumulate_y( Itr begin, Itr end )
 
 int main( int argc, char * argv[] )
  {
-  assert(argc==3) ;
+  assert(argc>=3) ;
   std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
   std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  reject_kernels(argc,argv) ;
 
   std::list<XY> collection(size) ;
   auto begin {std::begin(collection)} ;
@@ -47,8 +51,8 @@ int main( int argc, char * argv[] )
 
   randomize_x(begin,end) ;
   double volatile a {0.1} ;
-  while (repeat--)
-    saxpy(begin,end,a) ;
+  repeat_saxpy(begin,end,tile,repeat,[&]( auto first, auto last )
+   { saxpy(first,last,a) ; }) ;
   double res {accumulate_y(begin,end)/size} ;
   std::cout<<std::format("{}",res)<<std::endl ;
  }
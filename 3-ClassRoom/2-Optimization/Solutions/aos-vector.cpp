@@ -1,8 +1,15 @@
+#include "simd-kernels.h"
+#include "arrays-options.h"
+#include "tiling.h"
+#include "reduction.h"
 #include <iostream>
 #include <cassert> // for assert
 #include <cstdlib> // for rand
 #include <vector>
 #include <format>
+#include <iterator> // for std::contiguous_iterator
+#include <memory> // for std::to_address
+#include <optional>
 
 struct XY
  {
@@ -35,11 +42,36 @@ double accumulate_y( Itr begin, Itr end )
   return res ;
  }
 
+// explicitly vectorized variants, for a contiguous collection
+// whose elements are seen as interleaved {x,y} pairs of doubles
+
+static_assert(sizeof(XY)==2*sizeof(double)) ;
+
+template< std::contiguous_iterator Itr >
+void saxpy( simd::Kernels const & kernels, Itr begin, Itr end, double a )
+ { kernels.saxpy_xy(end-begin,a,&std::to_address(begin)->x) ; }
+
+template< std::contiguous_iterator Itr >
+double accumulate_y( simd::Kernels const & kernels, Itr begin, Itr end )
+ { return kernels.sum_y(end-begin,&std::to_address(begin)->x) ; }
+
+// with a chosen summation algorithm, for a random access collection
+template< std::random_access_iterator Itr >
+double accumulate_y( reduction::Summation summation, Itr begin, Itr end )
+ {
+  auto value = [begin]( std::size_t i ){ return begin[i].y ; } ;
+  return reduction::reduce(summation,static_cast<std::size_t>(end-begin),value) ;
+ }
+
 int main( int argc, char * argv[] )
  {
-  assert(argc==3) ;
+  assert(argc>=3) ;
   std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
   std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  std::optional<reduction::Summation> summation ;
+  if (!option(argc,argv,"sum").empty())
+    summation = select_option(argc,argv,"sum","naive|blocked|pairwise|neumaier",reduction::select_summation) ;
 
   std::vector<XY> collection(size) ;
   auto begin {std::begin(collection)} ;
@@ -47,8 +79,12 @@ int main( int argc, char * argv[] )
 
   randomize_x(begin,end) ;
   double volatile a {0.1} ;
-  while (repeat--)
-    saxpy(begin,end,a) ;
-  double res {accumulate_y(begin,end)/size} ;
+  double res {with_kernels(argc,argv,[&]( auto const & ... kernels )
+   {
+    repeat_saxpy(begin,end,tile,repeat,[&]( auto first, auto last )
+     { saxpy(kernels...,first,last,a) ; }) ;
+    if (summation) return accumulate_y(*summation,begin,end)/size ;
+    return accumulate_y(kernels...,begin,end)/size ;
+   })} ;
   std::cout<<std::format("{}",res)<<std::endl ;
  }
@@ -0,0 +1,54 @@
+#include "aosoa.h"
+#include "arrays-options.h"
+#include "tiling.h"
+#include <iostream>
+#include <cassert> // for assert
+#include <cstdlib> // for rand
+#include <format>
+
+template< typename Itr >
+void randomize_x( Itr begin, Itr end )
+ {
+  srand(1) ;
+  for ( ; begin!=end ; ++begin )
+   { begin->x = std::rand()/(RAND_MAX+1.)-0.5 ; }
+ }
+
+template< typename Itr >
+void saxpy( Itr begin, Itr end, double a )
+ {
+  for ( ; begin!=end ; ++begin )
+   { begin->saxpy(a) ; }
+ }
+
+template< typename Itr >
+double accumulate_y( Itr begin, Itr end )
+ {
+  double res {0.} ;
+  for ( ; begin!=end ; ++begin )
+   { res += begin->y ; }
+  return res ;
+ }
+
+// the generic templates above also apply to the AoSoA iterators, but
+// the more specialized saxpy and accumulate_y of aosoa.h take precedence
+
+int main( int argc, char * argv[] )
+ {
+  assert(argc>=3) ;
+  std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
+  std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  reject_kernels(argc,argv) ;
+
+  AoSoA<8> collection(size) ;
+  auto begin {std::begin(collection)} ;
+  auto end {std::end(collection)} ;
+
+  randomize_x(begin,end) ;
+  double volatile a {0.1} ;
+  repeat_saxpy(begin,end,tile,repeat,[&]( auto first, auto last )
+   { saxpy(first,last,a) ; }) ;
+  double res {accumulate_y(begin,end)/size} ;
+  std::cout<<std::format("{}",res)<<std::endl ;
+ }
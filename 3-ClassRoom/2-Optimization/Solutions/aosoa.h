@@ -0,0 +1,130 @@
+#ifndef AOSOA_H
+#define AOSOA_H
+
+#include <cstddef> // for std::size_t & std::ptrdiff_t
+#include <iterator>
+#include <vector>
+
+// AoSoA (array of structs of arrays) of {x,y} : the elements are stored by
+// blocks of Width x followed by Width y, so that a kernel keeps contiguous
+// SIMD-width accesses, while x and y of an element stay close in memory.
+
+// one block, aligned on a cache line
+template< std::size_t Width >
+struct AoSoABlock
+ {
+  alignas(64) double xs[Width] {} ;
+  double ys[Width] {} ;
+ } ;
+
+// proxy for one element, which offers the same interface as XY
+struct XYRef
+ {
+  double & x ;
+  double & y ;
+  void saxpy( double a )
+   { y = a*x + y ; }
+ } ;
+
+template< std::size_t Width >
+class AoSoAIterator
+ {
+  public :
+
+    using value_type = XYRef ;
+    using reference = XYRef ;
+    using difference_type = std::ptrdiff_t ;
+    // a proxy returned by value is no reference, as the legacy forward
+    // iterators require, but it satisfies std::forward_iterator
+    using iterator_category = std::input_iterator_tag ;
+    using iterator_concept = std::forward_iterator_tag ;
+
+    // what operator-> returns, since there is no real XY to point to
+    struct Arrow
+     {
+      XYRef ref ;
+      XYRef * operator->() { return &ref ; }
+     } ;
+
+    AoSoAIterator() = default ;
+    AoSoAIterator( AoSoABlock<Width> * blocks, std::size_t indice )
+     : m_blocks{blocks}, m_indice{indice} {}
+
+    XYRef operator*() const
+     {
+      auto & block {m_blocks[m_indice/Width]} ;
+      return { block.xs[m_indice%Width], block.ys[m_indice%Width] } ;
+     }
+    Arrow operator->() const { return { **this } ; }
+    AoSoAIterator & operator++() { ++m_indice ; return *this ; }
+    AoSoAIterator operator++( int ) { auto res {*this} ; ++m_indice ; return res ; }
+    bool operator==( AoSoAIterator const & other ) const { return m_indice==other.m_indice ; }
+
+    AoSoABlock<Width> * blocks() const { return m_blocks ; }
+    std::size_t indice() const { return m_indice ; }
+
+  private :
+
+    AoSoABlock<Width> * m_blocks {nullptr} ;
+    std::size_t m_indice {0} ;
+ } ;
+
+template< std::size_t Width = 8 >
+class AoSoA
+ {
+  public :
+    static constexpr std::size_t width {Width} ;
+    using iterator = AoSoAIterator<Width> ;
+    explicit AoSoA( std::size_t size ) : m_size{size}, m_blocks((size+Width-1)/Width) {}
+    std::size_t size() const { return m_size ; }
+    iterator begin() { return { m_blocks.data(), 0 } ; }
+    iterator end() { return { m_blocks.data(), m_size } ; }
+    XYRef operator[]( std::size_t indice ) { return *iterator(m_blocks.data(),indice) ; }
+  private :
+    std::size_t m_size ;
+    std::vector<AoSoABlock<Width>> m_blocks ;
+ } ;
+
+// The generic iterator-based saxpy(begin,end,a) and accumulate_y(begin,end)
+// work as is with AoSoAIterator. The overloads below are more specialized,
+// and so preferred : they process the full blocks with a fixed-width inner
+// loop. The one of saxpy vectorizes, while the one of accumulate_y keeps
+// the order of its additions, unless the compiler may reassociate them.
+
+template< std::size_t Width >
+void saxpy( AoSoAIterator<Width> begin, AoSoAIterator<Width> end, double a )
+ {
+  AoSoABlock<Width> * blocks {begin.blocks()} ;
+  std::size_t i {begin.indice()}, last {end.indice()} ;
+  for ( ; (i<last)&&((i%Width)!=0) ; ++i )
+   { (*AoSoAIterator<Width>(blocks,i)).saxpy(a) ; }
+  for ( ; i+Width<=last ; i+=Width )
+   {
+    AoSoABlock<Width> & block {blocks[i/Width]} ;
+    for ( std::size_t j=0 ; j<Width ; ++j )
+      block.ys[j] = a*block.xs[j] + block.ys[j] ;
+   }
+  for ( ; i<last ; ++i )
+   { (*AoSoAIterator<Width>(blocks,i)).saxpy(a) ; }
+ }
+
+template< std::size_t Width >
+double accumulate_y( AoSoAIterator<Width> begin, AoSoAIterator<Width> end )
+ {
+  AoSoABlock<Width> * blocks {begin.blocks()} ;
+  std::size_t i {begin.indice()}, last {end.indice()} ;
+  double res {0.} ;
+  for ( ; (i<last)&&((i%Width)!=0) ; ++i )
+   { res += (*AoSoAIterator<Width>(blocks,i)).y ; }
+  for ( ; i+Width<=last ; i+=Width )
+   {
+    AoSoABlock<Width> const & block {blocks[i/Width]} ;
+    for ( std::size_t j=0 ; j<Width ; ++j )
+      res += block.ys[j] ;
+   }
+  for ( ; i<last ; ++i )
+   { res += (*AoSoAIterator<Width>(blocks,i)).y ; }
+  return res ;
+ }
+
+#endif
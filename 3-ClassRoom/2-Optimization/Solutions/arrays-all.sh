@@ -12,13 +12,17 @@ rm -f tmp.*.log
 ./arrays.sh 20 2 aos-array    1024 2000000
 ./arrays.sh 20 2 aos-valarray 1024 2000000
 ./arrays.sh 20 2 aos-vector   1024 2000000
+./arrays.sh 20 2 aosoa-vector 1024 2000000
 #./arrays.sh 20 2 aos-list     1024 200000
+./arrays.sh 20 2 aos-colony   1024 2000000
 
 ./arrays.sh 20 3 aos-carray   1024 2000000
 ./arrays.sh 20 3 aos-array    1024 2000000
 ./arrays.sh 20 3 aos-valarray 1024 2000000
 ./arrays.sh 20 3 aos-vector   1024 2000000
+./arrays.sh 20 3 aosoa-vector 1024 2000000
 #./arrays.sh 20 3 aos-list     1024 200000
+./arrays.sh 20 3 aos-colony   1024 2000000
 
 #./arrays.sh 20 0 soa-carray   1024 200000
 #./arrays.sh 20 0 soa-array    1024 200000
@@ -29,11 +33,39 @@ rm -f tmp.*.log
 ./arrays.sh 20 2 soa-carray   1024 2000000
 ./arrays.sh 20 2 soa-array    1024 2000000
 ./arrays.sh 20 2 soa-valarray 1024 2000000
+./arrays.sh 20 2 soa-lazy     1024 2000000
 ./arrays.sh 20 2 soa-vector   1024 2000000
+./arrays.sh 20 2 soa-aligned  1024 2000000
 #./arrays.sh 20 2 soa-list     1024 200000
+./arrays.sh 20 2 soa-colony   1024 2000000
 
 ./arrays.sh 20 3 soa-carray   1024 2000000
 ./arrays.sh 20 3 soa-array    1024 2000000
 ./arrays.sh 20 3 soa-valarray 1024 2000000
+./arrays.sh 20 3 soa-lazy     1024 2000000
 ./arrays.sh 20 3 soa-vector   1024 2000000
+./arrays.sh 20 3 soa-aligned  1024 2000000
 #./arrays.sh 20 3 soa-list     1024 200000
+./arrays.sh 20 3 soa-colony   1024 2000000
+
+./arrays.sh 20 2 aos-vector   1024 2000000 --kernel=scalar
+./arrays.sh 20 2 aos-vector   1024 2000000 --kernel=auto
+./arrays.sh 20 2 soa-vector   1024 2000000 --kernel=scalar
+./arrays.sh 20 2 soa-vector   1024 2000000 --kernel=auto
+
+./arrays.sh 20 3 soa-aligned  100000000 10 --threads=1
+./arrays.sh 20 3 soa-aligned  100000000 10 --threads=$(nproc)
+
+./arrays.sh 20 3 aos-vector   10000000 100
+./arrays.sh 20 3 aos-vector   10000000 100 --tile=8192
+./arrays.sh 20 3 soa-vector   10000000 100
+./arrays.sh 20 3 soa-vector   10000000 100 --tile=8192
+
+./arrays.sh 20 3 aos-vector   1000000 10 --sum=neumaier
+./arrays.sh 20 3 soa-aligned  1000000 10 --sum=neumaier
+./arrays.sh 20 3 soa-aligned  1000000 10 --sum=neumaier --threads=$(nproc)
+
+./arrays.sh 20 3 aos-dynarray 2000 1 --events=100000
+./arrays.sh 20 3 aos-dynarray 2000 1 --events=100000 --alloc=arena
+./arrays.sh 20 3 aos-dynarray 2000 1 --events=100000 --alloc=pool
+./arrays.sh 20 3 aos-dynarray 20000000 10 --pages=huge
@@ -0,0 +1,462 @@
+// Benchmark driver for the arrays chapter : one executable which runs the
+// saxpy of every layout (AoS or SoA) with every kind of container, for a
+// sweep of sizes going from the L1 cache up to the main memory. Each
+// variant does the saxpy loop of the program of the same name.
+//
+// usage: arrays-bench.exe [--min=256] [--max=16777216] [--runs=10]
+//          [--work=16777216] [--layouts=aos-vector,soa-vector,...]
+//          [--format=text|csv|json]
+//
+// For each size, saxpy is repeated until about "work" elements have been
+// processed, and this is timed "runs" times after one warm-up run.
+
+#include "soa-aligned.h"
+#include "aosoa.h"
+#include "colony.h"
+#include "arrays-options.h"
+#include <iostream>
+#include <cassert> // for assert
+#include <cstdlib> // for rand
+#include <array>
+#include <chrono>
+#include <cmath> // for std::sqrt
+#include <algorithm> // for std::fill_n
+#include <functional>
+#include <iterator> // for std::next
+#include <list>
+#include <memory> // for std::unique_ptr
+#include <string>
+#include <string_view>
+#include <utility> // for std::move
+#include <valarray>
+#include <vector>
+#include <format>
+
+//==============================================
+// containers
+//==============================================
+
+// classic C array, only wrapped so to be built from a size
+template< typename T >
+class CArray
+ {
+  public :
+    explicit CArray( std::size_t size ) : m_size{size}, m_data{new T[size]} {}
+    CArray( CArray const & ) = delete ;
+    CArray & operator=( CArray const & ) = delete ;
+    ~CArray() { delete [] m_data ; }
+    T * begin() { return m_data ; }
+    T * end() { return m_data+m_size ; }
+    T * data() { return m_data ; }
+    T const * data() const { return m_data ; }
+  private :
+    std::size_t m_size ;
+    T * m_data ;
+ } ;
+
+// std::array of a fixed maximum size, partially used ; the arrays are
+// recycled from one run to the next, and only their used part is reset,
+// rather than allocating and zeroing N elements for each run
+template< typename T, std::size_t N >
+class PartialArray
+ {
+  public :
+    static constexpr std::size_t size_max {N} ;
+    explicit PartialArray( std::size_t size ) : m_size{size}, m_data{take()}
+     {
+      assert(size<=N) ;
+      std::fill_n(m_data->begin(),m_size,T{}) ;
+     }
+    ~PartialArray() { pool().push_back(std::move(m_data)) ; }
+    auto begin() { return m_data->begin() ; }
+    auto end() { return m_data->begin()+m_size ; }
+    T & operator[]( std::size_t indice ) { return (*m_data)[indice] ; }
+    T const & operator[]( std::size_t indice ) const { return (*m_data)[indice] ; }
+  private :
+    using Data = std::unique_ptr<std::array<T,N>> ;
+    static std::vector<Data> & pool()
+     {
+      static std::vector<Data> arrays ;
+      return arrays ;
+     }
+    static Data take()
+     {
+      if (pool().empty()) return Data{new std::array<T,N>} ;
+      Data data {std::move(pool().back())} ;
+      pool().pop_back() ;
+      return data ;
+     }
+    std::size_t m_size ;
+    Data m_data ;
+ } ;
+
+template< typename T >
+class DynArray
+ {
+  public :
+    explicit DynArray( std::size_t size ) : m_size{size}, m_data{new T [size]} {}
+    DynArray( DynArray const & ) = delete ;
+    DynArray & operator=( DynArray const & ) = delete ;
+    T * begin() { return m_data ; }
+    T * end() { return m_data+m_size ; }
+    std::size_t size() { return m_size ; }
+    T & operator[]( std::size_t indice ) { return m_data[indice] ; }
+    T const & operator[]( std::size_t indice ) const { return m_data[indice] ; }
+    ~DynArray() { delete [] m_data ; }
+  private :
+    std::size_t m_size ;
+    T * m_data ;
+ } ;
+
+constexpr std::size_t array_size_max {1<<20} ;
+constexpr std::size_t list_size_max {1<<22} ;
+constexpr std::size_t no_size_max {~std::size_t{0}} ;
+
+//==============================================
+// AoS
+//==============================================
+
+struct XY
+ {
+  double x, y {0.} ;
+  void saxpy( double a )
+   { y = a*x + y ; }
+ } ;
+
+template< typename Itr >
+void randomize_x( Itr begin, Itr end )
+ {
+  srand(1) ;
+  for ( ; begin!=end ; ++begin )
+   { begin->x = std::rand()/(RAND_MAX+1.)-0.5 ; }
+ }
+
+template< typename Itr >
+void saxpy( Itr begin, Itr end, double a )
+ {
+  for ( ; begin!=end ; ++begin )
+   { begin->saxpy(a) ; }
+ }
+
+template< typename Itr >
+double accumulate_y( Itr begin, Itr end )
+ {
+  double res {0.} ;
+  for ( ; begin!=end ; ++begin )
+   { res += begin->y ; }
+  return res ;
+ }
+
+// saxpy of the size first elements of the collection
+template< typename Container >
+void saxpy( Container & collection, std::size_t size, double a )
+ {
+  auto begin {std::begin(collection)} ;
+  saxpy(begin,std::next(begin,size),a) ;
+ }
+
+// as in aos-colony, one contiguous run of elements after the other
+void saxpy( Colony<XY> & collection, std::size_t, double a )
+ {
+  collection.for_each_block([a]( XY * xys, std::size_t count )
+   {
+    for ( std::size_t i=0 ; i<count ; ++i )
+      xys[i].saxpy(a) ;
+   }) ;
+ }
+
+//==============================================
+// SoA
+//==============================================
+
+// the saxpy loop of each SoA program : indexed by default,
+// as in soa-array and soa-vector
+template< typename Container >
+void saxpy( Container const & xs, Container & ys, std::size_t size, double a )
+ {
+  for ( std::size_t i=0 ; i<size ; ++i )
+    ys[i] = a*xs[i] + ys[i] ;
+ }
+
+// as in soa-carray, through pointers which do not alias
+void saxpy( CArray<double> const & xs, CArray<double> & ys, std::size_t size, double a )
+ {
+  double const * __restrict__ pxs {xs.data()} ;
+  double * __restrict__ pys {ys.data()} ;
+  for ( std::size_t i=0 ; i<size ; ++i )
+    pys[i] = a*pxs[i] + pys[i] ;
+ }
+
+// as in soa-valarray, with the valarray expression
+void saxpy( std::valarray<double> const & xs, std::valarray<double> & ys, std::size_t, double a )
+ { ys = a*xs + ys ; }
+
+// as in soa-list, with the iterators
+void saxpy( std::list<double> const & xs, std::list<double> & ys, std::size_t, double a )
+ {
+  auto pxs {xs.begin()} ;
+  for ( auto pys {ys.begin()} ; pys!=ys.end() ; ++pxs, ++pys )
+    *pys = a*(*pxs) + (*pys) ;
+ }
+
+// as in soa-colony, one contiguous block after the other
+void saxpy( Colony<double> const & xs, Colony<double> & ys, std::size_t, double a )
+ {
+  for ( std::size_t num=0 ; num<xs.nb_blocks() ; ++num )
+   {
+    double const * pxs {xs.block(num).data()} ;
+    double * pys {ys.block(num).data()} ;
+    std::size_t count {xs.block(num).size()} ;
+    for ( std::size_t i=0 ; i<count ; ++i )
+      pys[i] = a*pxs[i] + pys[i] ;
+   }
+ }
+
+template< typename Container >
+class SoA
+ {
+  public :
+    SoA( std::size_t size ) : m_size{size}, m_xs(size), m_ys(size) {}
+    void randomize_x()
+     {
+      srand(1) ;
+      auto xs {std::begin(m_xs)} ;
+      for ( std::size_t i=0 ; i<m_size ; ++i, ++xs )
+       { *xs = std::rand()/(RAND_MAX+1.)-0.5 ; }
+     }
+    void saxpy( double a )
+     { ::saxpy(m_xs,m_ys,m_size,a) ; }
+    double accumulate_y()
+     {
+      double res {0.} ;
+      auto ys {std::begin(m_ys)} ;
+      for ( std::size_t i=0 ; i<m_size ; ++i, ++ys )
+       { res += *ys ; }
+      return res ;
+     }
+  private :
+    std::size_t m_size ;
+    Container m_xs ;
+    Container m_ys ;
+ } ;
+
+// the SoA of the generic aligned container
+class AlignedXY
+ {
+  public :
+    AlignedXY( std::size_t size ) : m_soa(size) {}
+    void randomize_x()
+     {
+      srand(1) ;
+      double * xs {m_soa.data<&XY::x>()} ;
+      for ( std::size_t i=0 ; i<m_soa.size() ; ++i )
+       { xs[i] = std::rand()/(RAND_MAX+1.)-0.5 ; }
+     }
+    void saxpy( double a )
+     {
+      double const * __restrict__ xs {m_soa.data<&XY::x>()} ;
+      double * __restrict__ ys {m_soa.data<&XY::y>()} ;
+      std::size_t size {m_soa.padded_size()/lanes*lanes} ;
+      for ( std::size_t i=0 ; i<size ; ++i )
+        ys[i] = a*xs[i] + ys[i] ;
+     }
+    double accumulate_y()
+     {
+      double res {0.} ;
+      double const * ys {m_soa.data<&XY::y>()} ;
+      for ( std::size_t i=0 ; i<m_soa.size() ; ++i )
+       { res += ys[i] ; }
+      return res ;
+     }
+  private :
+    using Impl = AlignedSoA<XY,&XY::x,&XY::y> ;
+    static constexpr std::size_t lanes {Impl::lanes} ;
+    Impl m_soa ;
+ } ;
+
+//==============================================
+// timing
+//==============================================
+
+double volatile sink ;
+
+// time in seconds of repeat saxpy on size elements
+using Bench = std::function<double( std::size_t size, std::size_t repeat )> ;
+
+template< typename Fonction >
+double chrono( Fonction f )
+ {
+  using namespace std::chrono ;
+  auto t1 {steady_clock::now()} ;
+  f() ;
+  auto t2 {steady_clock::now()} ;
+  return duration<double>(t2-t1).count() ;
+ }
+
+template< typename Container >
+double bench_aos( std::size_t size, std::size_t repeat )
+ {
+  Container collection(size) ;
+  auto begin {std::begin(collection)} ;
+  auto end {std::next(begin,size)} ;
+  randomize_x(begin,end) ;
+  double volatile a {0.1} ;
+  double dt {chrono([&]{ for ( std::size_t r=0 ; r<repeat ; ++r ) saxpy(collection,size,a) ; })} ;
+  sink = accumulate_y(begin,end) ;
+  return dt ;
+ }
+
+template< typename Collection >
+double bench_soa( std::size_t size, std::size_t repeat )
+ {
+  Collection collection(size) ;
+  collection.randomize_x() ;
+  double volatile a {0.1} ;
+  double dt {chrono([&]{ for ( std::size_t r=0 ; r<repeat ; ++r ) collection.saxpy(a) ; })} ;
+  sink = collection.accumulate_y() ;
+  return dt ;
+ }
+
+//==============================================
+// registry
+//==============================================
+
+struct Layout
+ {
+  std::string name ;
+  std::size_t size_max ;
+  Bench bench ;
+ } ;
+
+std::vector<Layout> & layouts()
+ {
+  static std::vector<Layout> registry ;
+  return registry ;
+ }
+
+void register_layout( std::string name, std::size_t size_max, Bench bench )
+ { layouts().push_back({std::move(name),size_max,std::move(bench)}) ; }
+
+void register_all()
+ {
+  register_layout("aos-carray",no_size_max,bench_aos<CArray<XY>>) ;
+  register_layout("aos-array",array_size_max,bench_aos<PartialArray<XY,array_size_max>>) ;
+  register_layout("aos-valarray",no_size_max,bench_aos<std::valarray<XY>>) ;
+  register_layout("aos-vector",no_size_max,bench_aos<std::vector<XY>>) ;
+  register_layout("aos-list",list_size_max,bench_aos<std::list<XY>>) ;
+  register_layout("aos-dynarray",no_size_max,bench_aos<DynArray<XY>>) ;
+  register_layout("aos-colony",no_size_max,bench_aos<Colony<XY>>) ;
+  register_layout("aosoa-vector",no_size_max,bench_aos<AoSoA<8>>) ;
+  register_layout("soa-carray",no_size_max,bench_soa<SoA<CArray<double>>>) ;
+  register_layout("soa-array",array_size_max,bench_soa<SoA<PartialArray<double,array_size_max>>>) ;
+  register_layout("soa-valarray",no_size_max,bench_soa<SoA<std::valarray<double>>>) ;
+  register_layout("soa-vector",no_size_max,bench_soa<SoA<std::vector<double>>>) ;
+  register_layout("soa-list",list_size_max,bench_soa<SoA<std::list<double>>>) ;
+  register_layout("soa-dynarray",no_size_max,bench_soa<SoA<DynArray<double>>>) ;
+  register_layout("soa-colony",no_size_max,bench_soa<SoA<Colony<double>>>) ;
+  register_layout("soa-aligned",no_size_max,bench_soa<AlignedXY>) ;
+ }
+
+// is name in the comma-separated list (an empty list selects everything)
+bool selected( std::string_view name, std::string_view list )
+ {
+  if (list.empty()) return true ;
+  while (!list.empty())
+   {
+    auto comma {list.find(',')} ;
+    if (list.substr(0,comma)==name) return true ;
+    if (comma==std::string_view::npos) break ;
+    list.remove_prefix(comma+1) ;
+   }
+  return false ;
+ }
+
+//==============================================
+// results
+//==============================================
+
+struct Result
+ {
+  std::string layout ;
+  std::size_t size ;
+  std::size_t repeat ;
+  double ns_per_element ; // mean over the runs
+  double stddev ; // of ns_per_element
+  double gb_per_s ; // from the mean, counting x read, y read and y written
+ } ;
+
+Result measure( Layout const & layout, std::size_t size, std::size_t runs, std::size_t work )
+ {
+  std::size_t repeat {(work>size)?(work/size):1} ;
+  layout.bench(size,repeat) ; // warm-up
+  std::vector<double> nss ;
+  for ( std::size_t run=0 ; run<runs ; ++run )
+   { nss.push_back(layout.bench(size,repeat)*1.e9/(double(size)*repeat)) ; }
+  double mean {0.} ;
+  for ( double ns : nss ) mean += ns ;
+  mean /= runs ;
+  double variance {0.} ;
+  for ( double ns : nss ) variance += (ns-mean)*(ns-mean) ;
+  variance /= (runs>1)?(runs-1):1 ;
+  return { layout.name, size, repeat, mean, std::sqrt(variance), 3*sizeof(double)/mean } ;
+ }
+
+void print_header( std::string_view format )
+ {
+  if (format=="text")
+    std::cout<<std::format("{:>14} {:>10} {:>10} {:>10} {:>10} {:>8}\n",
+      "layout","size","repeat","ns/elem","stddev","GB/s") ;
+  else if (format=="csv")
+    std::cout<<"layout,size,repeat,ns_per_element,stddev,gb_per_s\n" ;
+  else
+    std::cout<<"[\n" ;
+ }
+
+void print( Result const & r, std::string_view format, bool first )
+ {
+  if (format=="text")
+    std::cout<<std::format("{:>14} {:>10} {:>10} {:>10.4f} {:>10.4f} {:>8.2f}\n",
+      r.layout,r.size,r.repeat,r.ns_per_element,r.stddev,r.gb_per_s) ;
+  else if (format=="csv")
+    std::cout<<std::format("{},{},{},{},{},{}\n",
+      r.layout,r.size,r.repeat,r.ns_per_element,r.stddev,r.gb_per_s) ;
+  else
+    std::cout<<std::format("{}  {{ \"layout\": \"{}\", \"size\": {}, \"repeat\": {}, "
+      "\"ns_per_element\": {}, \"stddev\": {}, \"gb_per_s\": {} }}",
+      (first?"":",\n"),r.layout,r.size,r.repeat,r.ns_per_element,r.stddev,r.gb_per_s) ;
+  std::cout<<std::flush ;
+ }
+
+void print_footer( std::string_view format )
+ {
+  if (format=="json") std::cout<<"\n]"<<std::endl ;
+ }
+
+int main( int argc, char * argv[] )
+ {
+  std::size_t size_min {size_option(argc,argv,"min",1<<8)} ;
+  std::size_t size_max {size_option(argc,argv,"max",1<<24)} ;
+  std::size_t runs {size_option(argc,argv,"runs",10)} ;
+  std::size_t work {size_option(argc,argv,"work",1<<24)} ;
+  std::string_view filter {option(argc,argv,"layouts")} ;
+  std::string_view format {option(argc,argv,"format","text")} ;
+  assert((size_min>0)&&(runs>0)) ;
+  if ((format!="text")&&(format!="csv")&&(format!="json"))
+    usage_error("unknown format: "+std::string(format),"--format=text|csv|json") ;
+
+  register_all() ;
+  print_header(format) ;
+  bool first {true} ;
+  for ( std::size_t size=size_min ; size<=size_max ; size*=2 )
+   {
+    for ( auto const & layout : layouts() )
+     {
+      if (!selected(layout.name,filter)||(size>layout.size_max)) continue ;
+      print(measure(layout,size,runs,work),format,first) ;
+      first = false ;
+     }
+    // the next size would be above size_max, or overflow
+    if (size>size_max/2) break ;
+   }
+  print_footer(format) ;
+ }
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+
+# expected arguments :
+# - which C++ standard to use : 20, 23, ...
+# - which level of optimization : 0, 1, 2, ...
+# - then any option of arrays-bench : --min=... --max=... --format=csv ...
+
+std=${1}
+shift
+opt=${1}
+shift
+
+# compile
+rm -f tmp.arrays-bench.exe
+g++ -std=c++${std} -O${opt} -march=native -mtune=native -funroll-loops -Wall -Wextra -Wfatal-errors arrays-bench.cpp -o tmp.arrays-bench.exe
+if [ $? -ne 0 ]; then
+  echo "COMPILATION ERROR"
+  exit 1
+fi
+
+# run
+./tmp.arrays-bench.exe ${*}
@@ -0,0 +1,74 @@
+#ifndef ARRAYS_OPTIONS_H
+#define ARRAYS_OPTIONS_H
+
+#include "simd-kernels.h"
+#include <cstddef> // for std::size_t
+#include <cstdlib> // for std::exit
+#include <iostream>
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+
+// value of an optional command-line argument of the form --name=value,
+// searched after the positional arguments, or default_value if absent
+inline std::string_view option
+ ( int argc, char * argv[], std::string_view name, std::string_view default_value = "" )
+ {
+  for ( int i=1 ; i<argc ; ++i )
+   {
+    std::string_view arg {argv[i]} ;
+    if ((arg.size()>name.size()+2)&&(arg.substr(0,2)=="--")&&
+        (arg.substr(2,name.size())==name)&&(arg[name.size()+2]=='='))
+     { return arg.substr(name.size()+3) ; }
+   }
+  return default_value ;
+ }
+
+// same for a numeric argument, such as --threads=4
+inline std::size_t size_option
+ ( int argc, char * argv[], std::string_view name, std::size_t default_value = 0 )
+ {
+  std::string_view value {option(argc,argv,name)} ;
+  if (value.empty()) return default_value ;
+  return std::stoull(std::string(value)) ;
+ }
+
+// stop the program on an invalid option, with the expected usage,
+// rather than with an uncaught exception
+[[noreturn]] inline void usage_error( std::string_view message, std::string_view usage )
+ {
+  std::cerr<<message<<"\nusage: "<<usage<<std::endl ;
+  std::exit(EXIT_FAILURE) ;
+ }
+
+// value of the option --name=..., given by select(value), which
+// throws std::runtime_error if the value is not one of values
+template< typename Select >
+decltype(auto) select_option
+ ( int argc, char * argv[], std::string_view name, std::string_view values,
+   Select select, std::string_view default_value = "" )
+ {
+  try { return select(option(argc,argv,name,default_value)) ; }
+  catch ( std::runtime_error const & error )
+   { usage_error(error.what(),"--"+std::string(name)+"="+std::string(values)) ; }
+ }
+
+// f() if there is no --kernel=..., else f(kernels), with the explicitly
+// vectorized kernels of the given name, selected before the call
+template< typename Function >
+decltype(auto) with_kernels( int argc, char * argv[], Function f )
+ {
+  if (option(argc,argv,"kernel").empty()) return f() ;
+  return f(select_option(argc,argv,"kernel","auto|scalar|sse2|avx2|avx512",simd::select_kernels)) ;
+ }
+
+// for the layouts which have no explicitly vectorized kernels, so
+// that --kernel=... is not silently ignored
+inline void reject_kernels( int argc, char * argv[] )
+ {
+  if (!option(argc,argv,"kernel").empty())
+    usage_error("no explicitly vectorized kernels for this layout",
+                std::string(argv[0])+" size repeat [--tile=...]") ;
+ }
+
+#endif
@@ -15,9 +15,16 @@ shift
 # header
 echo \# ${prog} ${opt}
 
+# the runs with --kernel=... select their instruction set at runtime,
+# so they are compiled for the baseline one, as simd-kernels.h requires
+arch="-march=native"
+for arg in "${@}"
+do case ${arg} in --kernel=*) arch="" ;; esac
+done
+
 # compile
 rm -f tmp.${prog}.exe
-g++ -std=c++${std} -O${opt} -march=native -mtune=native -funroll-loops -fopt-info-vec-all -Wall -Wextra -Wfatal-errors ${prog}.cpp -o tmp.${prog}.exe > tmp.${prog}.${opt}.log 2>&1
+g++ -std=c++${std} -O${opt} ${arch} -mtune=native -funroll-loops -fopt-info-vec-all -Wall -Wextra -Wfatal-errors ${prog}.cpp -o tmp.${prog}.exe > tmp.${prog}.${opt}.log 2>&1
 if [ $? -ne 0 ]; then
   echo "COMPILATION ERROR"
   exit 1
@@ -0,0 +1,193 @@
+#ifndef COLONY_H
+#define COLONY_H
+
+#include <algorithm> // for std::min
+#include <cassert> // for assert
+#include <cstddef> // for std::size_t & std::ptrdiff_t
+#include <iterator>
+#include <memory> // for std::unique_ptr
+#include <span>
+#include <vector>
+
+// Chunked container, also known as a "colony" or a segmented vector :
+// - the elements live in fixed-size blocks which never move, so the
+//   pointers and references to an element stay valid until it is erased ;
+// - erase is O(1) : the slot is only marked dead, and reused later by insert ;
+// - each element has a slot index, which is a random-access key with O(1)
+//   access, stable under insertion and erasure of the other elements ;
+// - the loops can run with for_each_block over the contiguous runs of
+//   elements, as over plain arrays, where the saxpy loops vectorize ;
+//   the iterators instead pay a division and a check per element.
+template< typename T, std::size_t BlockSize = 4096 >
+class Colony
+ {
+  private :
+
+    struct Block
+     {
+      T values[BlockSize] {} ;
+      bool alive[BlockSize] {} ;
+     } ;
+
+  public :
+
+    static constexpr std::size_t block_size {BlockSize} ;
+
+    template< typename Value, typename Owner >
+    class Iterator
+     {
+      public :
+        using value_type = T ;
+        using difference_type = std::ptrdiff_t ;
+        using iterator_category = std::forward_iterator_tag ;
+        Iterator() = default ;
+        Iterator( Owner * colony, std::size_t slot ) : m_colony{colony}, m_slot{slot} { skip() ; }
+        Value & operator*() const { return (*m_colony)[m_slot] ; }
+        Value * operator->() const { return &(*m_colony)[m_slot] ; }
+        Iterator & operator++() { ++m_slot ; skip() ; return *this ; }
+        Iterator operator++( int ) { auto res {*this} ; ++(*this) ; return res ; }
+        bool operator==( Iterator const & other ) const { return m_slot==other.m_slot ; }
+        std::size_t slot() const { return m_slot ; }
+      private :
+        void skip()
+         {
+          if (m_colony->dense()) return ;
+          while ((m_slot<m_colony->slots())&&(!m_colony->alive(m_slot))) ++m_slot ;
+         }
+        Owner * m_colony {nullptr} ;
+        std::size_t m_slot {0} ;
+     } ;
+
+    using iterator = Iterator<T,Colony> ;
+    using const_iterator = Iterator<T const,Colony const> ;
+
+    explicit Colony( std::size_t size = 0 )
+     {
+      for ( std::size_t i=0 ; i<size ; ++i )
+       { insert(T{}) ; }
+     }
+
+    std::size_t size() const { return m_size ; }
+    bool empty() const { return m_size==0 ; }
+
+    // number of slots in use, alive or dead ; the slots are in [0,slots())
+    std::size_t slots() const { return m_slots ; }
+
+    // true when there is no dead slot, so that all of [0,slots()) is alive
+    bool dense() const { return m_free.empty() ; }
+
+    bool alive( std::size_t slot ) const
+     { return m_blocks[slot/BlockSize]->alive[slot%BlockSize] ; }
+
+    T & operator[]( std::size_t slot )
+     { return m_blocks[slot/BlockSize]->values[slot%BlockSize] ; }
+    T const & operator[]( std::size_t slot ) const
+     { return m_blocks[slot/BlockSize]->values[slot%BlockSize] ; }
+
+    // insert in a dead slot if any, else at the end, and return the slot
+    std::size_t insert( T const & value )
+     {
+      std::size_t slot ;
+      if (!m_free.empty())
+       {
+        slot = m_free.back() ;
+        m_free.pop_back() ;
+       }
+      else
+       {
+        slot = m_slots++ ;
+        if (slot/BlockSize==m_blocks.size())
+          m_blocks.push_back(std::make_unique<Block>()) ;
+       }
+      (*this)[slot] = value ;
+      m_blocks[slot/BlockSize]->alive[slot%BlockSize] = true ;
+      ++m_size ;
+      return slot ;
+     }
+
+    // the dead value is kept as is in its slot, until the slot is reused ;
+    // the slot must be alive, else it would be queued twice for reuse
+    void erase( std::size_t slot )
+     {
+      assert((slot<m_slots)&&alive(slot)) ;
+      m_blocks[slot/BlockSize]->alive[slot%BlockSize] = false ;
+      m_free.push_back(slot) ;
+      --m_size ;
+     }
+
+    iterator erase( iterator itr )
+     {
+      std::size_t slot {itr.slot()} ;
+      erase(slot) ;
+      return { this, slot+1 } ;
+     }
+
+    iterator begin() { return { this, 0 } ; }
+    iterator end() { return { this, m_slots } ; }
+    const_iterator begin() const { return { this, 0 } ; }
+    const_iterator end() const { return { this, m_slots } ; }
+
+    // the contiguous blocks of slots, the last one being partially used ;
+    // unless dense(), some of these slots may be dead
+    std::size_t nb_blocks() const { return m_blocks.size() ; }
+    std::span<T> block( std::size_t num )
+     { return { m_blocks[num]->values, block_slots(num) } ; }
+    std::span<T const> block( std::size_t num ) const
+     { return { m_blocks[num]->values, block_slots(num) } ; }
+    std::span<bool const> block_alive( std::size_t num ) const
+     { return { m_blocks[num]->alive, block_slots(num) } ; }
+
+    // f(values,count) on each contiguous run of alive elements among the
+    // slots [begin,end), which are whole blocks when dense()
+    template< typename Function >
+    void for_each_block( std::size_t begin, std::size_t end, Function f )
+     { for_each_run(*this,begin,end,f) ; }
+    template< typename Function >
+    void for_each_block( std::size_t begin, std::size_t end, Function f ) const
+     { for_each_run(*this,begin,end,f) ; }
+    template< typename Function >
+    void for_each_block( Function f )
+     { for_each_run(*this,0,m_slots,f) ; }
+    template< typename Function >
+    void for_each_block( Function f ) const
+     { for_each_run(*this,0,m_slots,f) ; }
+
+  private :
+
+    template< typename Self, typename Function >
+    static void for_each_run( Self & self, std::size_t begin, std::size_t end, Function f )
+     {
+      while (begin<end)
+       {
+        std::size_t num {begin/BlockSize} ;
+        std::size_t offset {num*BlockSize} ;
+        std::size_t last {std::min(end,offset+BlockSize)} ;
+        auto values {self.block(num).data()} ;
+        if (self.dense())
+          f(values+(begin-offset),last-begin) ;
+        else
+         {
+          bool const * alive {self.block_alive(num).data()} ;
+          std::size_t slot {begin} ;
+          while (slot<last)
+           {
+            while ((slot<last)&&!alive[slot-offset]) ++slot ;
+            std::size_t first {slot} ;
+            while ((slot<last)&&alive[slot-offset]) ++slot ;
+            if (slot>first) f(values+(first-offset),slot-first) ;
+           }
+         }
+        begin = last ;
+       }
+     }
+
+    std::size_t block_slots( std::size_t num ) const
+     { return (num+1<m_blocks.size())?BlockSize:m_slots-num*BlockSize ; }
+
+    std::vector<std::unique_ptr<Block>> m_blocks ;
+    std::vector<std::size_t> m_free ;
+    std::size_t m_slots {0} ;
+    std::size_t m_size {0} ;
+ } ;
+
+#endif
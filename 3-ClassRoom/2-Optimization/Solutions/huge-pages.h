@@ -0,0 +1,57 @@
+#ifndef HUGE_PAGES_H
+#define HUGE_PAGES_H
+
+#include <cstddef> // for std::size_t
+#include <cstdlib> // for std::aligned_alloc & std::free
+#include <memory_resource>
+#include <new> // for std::bad_alloc
+
+#ifdef __linux__
+#include <sys/mman.h> // for madvise
+#endif
+
+// memory resource which backs the large allocations with 2 MiB transparent
+// huge pages, so that a big array needs far fewer TLB entries, and forwards
+// the small allocations to the upstream resource ; the huge pages are only
+// a hint to the kernel, which silently falls back to normal pages
+class HugePageResource : public std::pmr::memory_resource
+ {
+  public :
+
+    static constexpr std::size_t page_size {std::size_t{2}<<20} ;
+
+    explicit HugePageResource( std::pmr::memory_resource * upstream = std::pmr::new_delete_resource() )
+     : m_upstream{upstream} {}
+
+  private :
+
+    static std::size_t rounded( std::size_t bytes )
+     { return (bytes+page_size-1)/page_size*page_size ; }
+
+    void * do_allocate( std::size_t bytes, std::size_t alignment ) override
+     {
+      if ((bytes<page_size)||(alignment>page_size))
+        return m_upstream->allocate(bytes,alignment) ;
+      void * res {std::aligned_alloc(page_size,rounded(bytes))} ;
+      if (res==nullptr) throw std::bad_alloc() ;
+#ifdef __linux__
+      madvise(res,rounded(bytes),MADV_HUGEPAGE) ;
+#endif
+      return res ;
+     }
+
+    void do_deallocate( void * p, std::size_t bytes, std::size_t alignment ) override
+     {
+      if ((bytes<page_size)||(alignment>page_size))
+        m_upstream->deallocate(p,bytes,alignment) ;
+      else
+        std::free(p) ;
+     }
+
+    bool do_is_equal( std::pmr::memory_resource const & other ) const noexcept override
+     { return this==&other ; }
+
+    std::pmr::memory_resource * m_upstream ;
+ } ;
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef LAZY_ARRAY_H
+#define LAZY_ARRAY_H
+
+// Lazy arrays : the arithmetic operators do not compute anything, they only
+// build a tree of small expression nodes, which is evaluated element by
+// element in one single loop when assigned to an Array, or reduced by sum().
+// Hence no temporary array, and only one pass over the memory, whatever the
+// size of the expression.
+//
+// Every node has size() and operator[](i) ; the arrays enter the tree as
+// views (pointer and size), the scalars as constants, and the other nodes
+// are copied by value, which is cheap.
+
+#include <cassert> // for assert
+#include <cstddef> // for std::size_t
+#include <functional> // for std::plus & co
+#include <type_traits>
+#include <valarray>
+#include <vector>
+
+namespace lazy
+ {
+
+  //=====================================================
+  // what may enter an expression
+  //=====================================================
+
+  template< typename E >
+  inline constexpr bool is_node {false} ;
+
+  template< typename E >
+  concept Expression = is_node<std::remove_cvref_t<E>> ;
+
+  template< typename T >
+  concept Operand = Expression<T> || std::is_arithmetic_v<std::remove_cvref_t<T>> ;
+
+  //=====================================================
+  // leaves
+  //=====================================================
+
+  template< typename T >
+  class View
+   {
+    public :
+      View( T const * data, std::size_t size ) : m_data{data}, m_size{size} {}
+      std::size_t size() const { return m_size ; }
+      T operator[]( std::size_t i ) const { return m_data[i] ; }
+    private :
+      T const * m_data ;
+      std::size_t m_size ;
+   } ;
+
+  template< typename T >
+  inline constexpr bool is_node<View<T>> {true} ;
+
+  // existing data, such as a std::valarray, seen as a leaf
+  template< typename T >
+  View<T> view( std::valarray<T> const & values )
+   { return { std::begin(values), values.size() } ; }
+
+  template< typename T >
+  View<T> view( T const * data, std::size_t size )
+   { return { data, size } ; }
+
+  // same value for any index, and no size of its own
+  template< typename T >
+  class Scalar
+   {
+    public :
+      explicit Scalar( T value ) : m_value{value} {}
+      T operator[]( std::size_t ) const { return m_value ; }
+    private :
+      T m_value ;
+   } ;
+
+  template< typename T >
+  inline constexpr bool is_scalar {false} ;
+
+  template< typename T >
+  inline constexpr bool is_scalar<Scalar<T>> {true} ;
+
+  //=====================================================
+  // the array, which owns its data
+  //=====================================================
+
+  template< typename T >
+  class Array
+   {
+    public :
+
+      explicit Array( std::size_t size, T value = T{} ) : m_data(size,value) {}
+
+      template< Expression E >
+      Array( E const & expression ) : m_data(expression.size())
+       { evaluate(expression) ; }
+
+      template< Expression E >
+      Array & operator=( E const & expression )
+       {
+        assert(expression.size()==size()) ;
+        evaluate(expression) ;
+        return *this ;
+       }
+
+      Array & operator=( T value )
+       {
+        for ( T & element : m_data ) element = value ;
+        return *this ;
+       }
+
+      template< Operand E > Array & operator+=( E const & other ) { return *this = *this + other ; }
+      template< Operand E > Array & operator-=( E const & other ) { return *this = *this - other ; }
+      template< Operand E > Array & operator*=( E const & other ) { return *this = *this * other ; }
+      template< Operand E > Array & operator/=( E const & other ) { return *this = *this / other ; }
+
+      std::size_t size() const { return m_data.size() ; }
+      T & operator[]( std::size_t i ) { return m_data[i] ; }
+      T const & operator[]( std::size_t i ) const { return m_data[i] ; }
+      T * begin() { return m_data.data() ; }
+      T * end() { return m_data.data()+m_data.size() ; }
+      T const * begin() const { return m_data.data() ; }
+      T const * end() const { return m_data.data()+m_data.size() ; }
+
+    private :
+
+      // the array may appear in the expression itself, as in y = a*x + y,
+      // which is fine as long as each element only depends on the same index
+      template< Expression E >
+      void evaluate( E const & expression )
+       {
+        T * data {m_data.data()} ;
+        std::size_t size {m_data.size()} ;
+        for ( std::size_t i=0 ; i<size ; ++i )
+          data[i] = expression[i] ;
+       }
+
+      std::vector<T> m_data ;
+   } ;
+
+  template< typename T >
+  inline constexpr bool is_node<Array<T>> {true} ;
+
+  // how an operand is stored in a node
+  template< typename T >
+  View<T> node( Array<T> const & array )
+   { return { array.begin(), array.size() } ; }
+
+  template< Expression E >
+  E node( E const & expression )
+   { return expression ; }
+
+  template< typename T > requires std::is_arithmetic_v<T>
+  Scalar<T> node( T value )
+   { return Scalar<T>{value} ; }
+
+  //=====================================================
+  // inner nodes
+  //=====================================================
+
+  template< typename Op, typename L, typename R >
+  class Binary
+   {
+    public :
+      Binary( L lhs, R rhs ) : m_lhs{lhs}, m_rhs{rhs}
+       {
+        // a scalar fits any size, two expressions must have the same one
+        if constexpr (!is_scalar<L>&&!is_scalar<R>) assert(m_lhs.size()==m_rhs.size()) ;
+       }
+      std::size_t size() const
+       {
+        if constexpr (is_scalar<L>) return m_rhs.size() ;
+        else return m_lhs.size() ;
+       }
+      auto operator[]( std::size_t i ) const { return Op{}(m_lhs[i],m_rhs[i]) ; }
+    private :
+      L m_lhs ;
+      R m_rhs ;
+   } ;
+
+  template< typename Op, typename L, typename R >
+  inline constexpr bool is_node<Binary<Op,L,R>> {true} ;
+
+  template< typename Op, typename L, typename R >
+  auto binary( L const & lhs, R const & rhs )
+   {
+    auto l {node(lhs)} ;
+    auto r {node(rhs)} ;
+    return Binary<Op,decltype(l),decltype(r)>{l,r} ;
+   }
+
+  template< Operand L, Operand R > requires (Expression<L> || Expression<R>)
+  auto operator+( L const & lhs, R const & rhs ) { return binary<std::plus<>>(lhs,rhs) ; }
+
+  template< Operand L, Operand R > requires (Expression<L> || Expression<R>)
+  auto operator-( L const & lhs, R const & rhs ) { return binary<std::minus<>>(lhs,rhs) ; }
+
+  template< Operand L, Operand R > requires (Expression<L> || Expression<R>)
+  auto operator*( L const & lhs, R const & rhs ) { return binary<std::multiplies<>>(lhs,rhs) ; }
+
+  template< Operand L, Operand R > requires (Expression<L> || Expression<R>)
+  auto operator/( L const & lhs, R const & rhs ) { return binary<std::divides<>>(lhs,rhs) ; }
+
+  // integer power of each element, by repeated multiplications
+  template< typename E >
+  class Power
+   {
+    public :
+      Power( E expression, int power ) : m_expression{expression}, m_power{power} {}
+      std::size_t size() const { return m_expression.size() ; }
+      auto operator[]( std::size_t i ) const
+       {
+        auto value {m_expression[i]} ;
+        decltype(value) res {1} ;
+        for ( int j=0 ; j<m_power ; ++j )
+          res *= value ;
+        return res ;
+       }
+    private :
+      E m_expression ;
+      int m_power ;
+   } ;
+
+  template< typename E >
+  inline constexpr bool is_node<Power<E>> {true} ;
+
+  template< Expression E >
+  auto pow( E const & expression, int power )
+   {
+    auto e {node(expression)} ;
+    return Power<decltype(e)>{e,power} ;
+   }
+
+  //=====================================================
+  // reduction, also in one pass
+  //=====================================================
+
+  template< Expression E >
+  auto sum( E const & expression )
+   {
+    auto e {node(expression)} ;
+    decltype(e[0]) res {0} ;
+    std::size_t size {e.size()} ;
+    for ( std::size_t i=0 ; i<size ; ++i )
+      res += e[i] ;
+    return res ;
+   }
+
+ }
+
+#endif
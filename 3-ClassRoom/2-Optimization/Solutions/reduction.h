@@ -0,0 +1,134 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+// Summation of size values, given by value(i) for i in [0,size), with a
+// choice of algorithm :
+// - naive : one accumulator, error growing as O(size) ;
+// - blocked : 8 independent accumulators, that the compiler turns into
+//   SIMD registers, added at the end along a fixed tree ;
+// - pairwise : recursive halving down to blocks of 128, error in O(log(size)) ;
+// - neumaier : compensated (improved Kahan), error independent of size.
+//
+// The values are always cut in chunks of a fixed size, each summed
+// separately, then the partial sums are summed with the same algorithm.
+// Since the chunks do not depend on the number of threads, the result
+// is bitwise identical whatever the number of threads, including none.
+//
+// Do NOT compile with -ffast-math, which is allowed to reassociate the
+// additions, and so to remove the compensation and the fixed ordering.
+
+#include "thread-pool.h"
+#include <algorithm> // for std::min
+#include <cmath> // for std::abs
+#include <cstddef> // for std::size_t
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reduction
+ {
+
+  enum class Summation { naive, blocked, pairwise, neumaier } ;
+
+  // algorithm for a name among naive|blocked|pairwise|neumaier
+  inline Summation select_summation( std::string_view name )
+   {
+    if (name=="naive") return Summation::naive ;
+    if (name=="blocked") return Summation::blocked ;
+    if (name=="pairwise") return Summation::pairwise ;
+    if (name=="neumaier") return Summation::neumaier ;
+    throw std::runtime_error("unknown summation: "+std::string(name)) ;
+   }
+
+  constexpr std::size_t lanes {8} ;
+  constexpr std::size_t pairwise_block {128} ;
+  constexpr std::size_t chunk {1<<14} ;
+
+  //=====================================================
+  // sequential algorithms, on [begin,end)
+  //=====================================================
+
+  template< typename Value >
+  double naive_sum( std::size_t begin, std::size_t end, Value const & value )
+   {
+    double res {0.} ;
+    for ( std::size_t i=begin ; i<end ; ++i )
+     { res += value(i) ; }
+    return res ;
+   }
+
+  template< typename Value >
+  double blocked_sum( std::size_t begin, std::size_t end, Value const & value )
+   {
+    double acc[lanes] {} ;
+    std::size_t i {begin} ;
+    for ( ; i+lanes<=end ; i+=lanes )
+      for ( std::size_t j=0 ; j<lanes ; ++j )
+        acc[j] += value(i+j) ;
+    for ( std::size_t j=0 ; i<end ; ++i, ++j )
+     { acc[j] += value(i) ; }
+    for ( std::size_t width=lanes/2 ; width>0 ; width/=2 )
+      for ( std::size_t j=0 ; j<width ; ++j )
+        acc[j] += acc[j+width] ;
+    return acc[0] ;
+   }
+
+  template< typename Value >
+  double pairwise_sum( std::size_t begin, std::size_t end, Value const & value )
+   {
+    if (end-begin<=pairwise_block) return blocked_sum(begin,end,value) ;
+    std::size_t middle {begin+(end-begin)/2} ;
+    return pairwise_sum(begin,middle,value) + pairwise_sum(middle,end,value) ;
+   }
+
+  template< typename Value >
+  double neumaier_sum( std::size_t begin, std::size_t end, Value const & value )
+   {
+    double res {0.}, compensation {0.} ;
+    for ( std::size_t i=begin ; i<end ; ++i )
+     {
+      double v {value(i)} ;
+      double t {res+v} ;
+      if (std::abs(res)>=std::abs(v)) compensation += (res-t)+v ;
+      else compensation += (v-t)+res ;
+      res = t ;
+     }
+    return res+compensation ;
+   }
+
+  template< typename Value >
+  double sum( Summation summation, std::size_t begin, std::size_t end, Value const & value )
+   {
+    switch (summation)
+     {
+      case Summation::blocked : return blocked_sum(begin,end,value) ;
+      case Summation::pairwise : return pairwise_sum(begin,end,value) ;
+      case Summation::neumaier : return neumaier_sum(begin,end,value) ;
+      default : return naive_sum(begin,end,value) ;
+     }
+   }
+
+  //=====================================================
+  // by chunks, optionally multithreaded
+  //=====================================================
+
+  template< typename Value >
+  double reduce( Summation summation, std::size_t size, Value const & value, ThreadPool * pool = nullptr )
+   {
+    std::size_t nb_chunks {(size+chunk-1)/chunk} ;
+    std::vector<double> partials(nb_chunks) ;
+    auto work = [&]( std::size_t num, std::size_t nb )
+     {
+      auto [first,last] = slice(num,nb,nb_chunks) ;
+      for ( std::size_t c=first ; c<last ; ++c )
+        partials[c] = sum(summation,c*chunk,std::min((c+1)*chunk,size),value) ;
+     } ;
+    if (pool==nullptr) work(0,1) ;
+    else pool->run([&]( std::size_t num ){ work(num,pool->size()) ; }) ;
+    return sum(summation,0,nb_chunks,[&]( std::size_t c ){ return partials[c] ; }) ;
+   }
+
+ }
+
+#endif
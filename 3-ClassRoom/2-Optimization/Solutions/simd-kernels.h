@@ -0,0 +1,391 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+// Explicitly vectorized kernels, with a variant for each x86 instruction
+// set, and one set of variants selected at runtime from the CPU features.
+// The variants are compiled with per-function target attributes, so the
+// program itself should NOT be compiled with -march=native if the same
+// binary must run on older nodes.
+//
+// The "xy" kernels work on interleaved {x,y} pairs, as in an AoS of XY.
+//
+// The kernels are compiled without contraction of a*x+y into fused
+// multiply-adds, even with -march=native, so that saxpy and axpby give
+// the same results with all the variants, including the scalar
+// remainders ; the sums still differ by their order of additions.
+
+#include <cstddef> // for std::size_t
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+
+namespace simd
+ {
+
+  //=====================================================
+  // portable scalar fallback
+  //=====================================================
+
+  namespace scalar
+   {
+
+    inline void saxpy( std::size_t size, double a, double const * xs, double * ys )
+     { for ( std::size_t i=0 ; i<size ; ++i ) ys[i] = a*xs[i] + ys[i] ; }
+
+    inline void axpby( std::size_t size, double a, double const * xs, double b, double * ys )
+     { for ( std::size_t i=0 ; i<size ; ++i ) ys[i] = a*xs[i] + b*ys[i] ; }
+
+    inline double dot( std::size_t size, double const * xs, double const * ys )
+     {
+      double res {0.} ;
+      for ( std::size_t i=0 ; i<size ; ++i ) res += xs[i]*ys[i] ;
+      return res ;
+     }
+
+    inline double sum( std::size_t size, double const * xs )
+     {
+      double res {0.} ;
+      for ( std::size_t i=0 ; i<size ; ++i ) res += xs[i] ;
+      return res ;
+     }
+
+    inline void saxpy_xy( std::size_t size, double a, double * xys )
+     { for ( std::size_t i=0 ; i<2*size ; i+=2 ) xys[i+1] = a*xys[i] + xys[i+1] ; }
+
+    inline double sum_y( std::size_t size, double const * xys )
+     {
+      double res {0.} ;
+      for ( std::size_t i=0 ; i<2*size ; i+=2 ) res += xys[i+1] ;
+      return res ;
+     }
+
+   }
+
+#ifdef SIMD_KERNELS_X86
+
+  //=====================================================
+  // SSE2 : 2 doubles per register
+  //=====================================================
+
+  namespace sse2
+   {
+
+    __attribute__((target("sse2")))
+    inline void saxpy( std::size_t size, double a, double const * xs, double * ys )
+     {
+      __m128d va {_mm_set1_pd(a)} ;
+      std::size_t i {0} ;
+      for ( ; i+2<=size ; i+=2 )
+        _mm_storeu_pd(ys+i,_mm_add_pd(_mm_mul_pd(va,_mm_loadu_pd(xs+i)),_mm_loadu_pd(ys+i))) ;
+      scalar::saxpy(size-i,a,xs+i,ys+i) ;
+     }
+
+    __attribute__((target("sse2")))
+    inline void axpby( std::size_t size, double a, double const * xs, double b, double * ys )
+     {
+      __m128d va {_mm_set1_pd(a)}, vb {_mm_set1_pd(b)} ;
+      std::size_t i {0} ;
+      for ( ; i+2<=size ; i+=2 )
+        _mm_storeu_pd(ys+i,_mm_add_pd(_mm_mul_pd(va,_mm_loadu_pd(xs+i)),_mm_mul_pd(vb,_mm_loadu_pd(ys+i)))) ;
+      scalar::axpby(size-i,a,xs+i,b,ys+i) ;
+     }
+
+    __attribute__((target("sse2")))
+    inline double hsum( __m128d v )
+     { return _mm_cvtsd_f64(_mm_add_sd(v,_mm_unpackhi_pd(v,v))) ; }
+
+    __attribute__((target("sse2")))
+    inline double dot( std::size_t size, double const * xs, double const * ys )
+     {
+      __m128d acc {_mm_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+2<=size ; i+=2 )
+        acc = _mm_add_pd(acc,_mm_mul_pd(_mm_loadu_pd(xs+i),_mm_loadu_pd(ys+i))) ;
+      return hsum(acc) + scalar::dot(size-i,xs+i,ys+i) ;
+     }
+
+    __attribute__((target("sse2")))
+    inline double sum( std::size_t size, double const * xs )
+     {
+      __m128d acc {_mm_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+2<=size ; i+=2 )
+        acc = _mm_add_pd(acc,_mm_loadu_pd(xs+i)) ;
+      return hsum(acc) + scalar::sum(size-i,xs+i) ;
+     }
+
+    // one {x,y} pair per register : [x y] -> [x a*x+y]
+    __attribute__((target("sse2")))
+    inline void saxpy_xy( std::size_t size, double a, double * xys )
+     {
+      __m128d va {_mm_set1_pd(a)} ;
+      for ( std::size_t i=0 ; i<2*size ; i+=2 )
+       {
+        __m128d v {_mm_loadu_pd(xys+i)} ;
+        __m128d r {_mm_add_pd(_mm_mul_pd(va,_mm_unpacklo_pd(v,v)),v)} ;
+        _mm_storeu_pd(xys+i,_mm_move_sd(r,v)) ;
+       }
+     }
+
+    __attribute__((target("sse2")))
+    inline double sum_y( std::size_t size, double const * xys )
+     {
+      __m128d acc {_mm_setzero_pd()} ;
+      for ( std::size_t i=0 ; i<2*size ; i+=2 )
+        acc = _mm_add_pd(acc,_mm_loadu_pd(xys+i)) ;
+      return _mm_cvtsd_f64(_mm_unpackhi_pd(acc,acc)) ;
+     }
+
+   }
+
+  //=====================================================
+  // AVX2 : 4 doubles per register
+  // (no FMA, so that the results stay identical to SSE2)
+  //=====================================================
+
+  namespace avx2
+   {
+
+    __attribute__((target("avx2")))
+    inline void saxpy( std::size_t size, double a, double const * xs, double * ys )
+     {
+      __m256d va {_mm256_set1_pd(a)} ;
+      std::size_t i {0} ;
+      for ( ; i+4<=size ; i+=4 )
+        _mm256_storeu_pd(ys+i,_mm256_add_pd(_mm256_mul_pd(va,_mm256_loadu_pd(xs+i)),_mm256_loadu_pd(ys+i))) ;
+      scalar::saxpy(size-i,a,xs+i,ys+i) ;
+     }
+
+    __attribute__((target("avx2")))
+    inline void axpby( std::size_t size, double a, double const * xs, double b, double * ys )
+     {
+      __m256d va {_mm256_set1_pd(a)}, vb {_mm256_set1_pd(b)} ;
+      std::size_t i {0} ;
+      for ( ; i+4<=size ; i+=4 )
+        _mm256_storeu_pd(ys+i,_mm256_add_pd(_mm256_mul_pd(va,_mm256_loadu_pd(xs+i)),_mm256_mul_pd(vb,_mm256_loadu_pd(ys+i)))) ;
+      scalar::axpby(size-i,a,xs+i,b,ys+i) ;
+     }
+
+    __attribute__((target("avx2")))
+    inline double hsum( __m256d v )
+     {
+      __m128d s {_mm_add_pd(_mm256_castpd256_pd128(v),_mm256_extractf128_pd(v,1))} ;
+      return _mm_cvtsd_f64(_mm_add_sd(s,_mm_unpackhi_pd(s,s))) ;
+     }
+
+    __attribute__((target("avx2")))
+    inline double dot( std::size_t size, double const * xs, double const * ys )
+     {
+      __m256d acc {_mm256_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+4<=size ; i+=4 )
+        acc = _mm256_add_pd(acc,_mm256_mul_pd(_mm256_loadu_pd(xs+i),_mm256_loadu_pd(ys+i))) ;
+      return hsum(acc) + scalar::dot(size-i,xs+i,ys+i) ;
+     }
+
+    __attribute__((target("avx2")))
+    inline double sum( std::size_t size, double const * xs )
+     {
+      __m256d acc {_mm256_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+4<=size ; i+=4 )
+        acc = _mm256_add_pd(acc,_mm256_loadu_pd(xs+i)) ;
+      return hsum(acc) + scalar::sum(size-i,xs+i) ;
+     }
+
+    // two {x,y} pairs per register : [x0 y0 x1 y1] -> [x0 a*x0+y0 x1 a*x1+y1]
+    __attribute__((target("avx2")))
+    inline void saxpy_xy( std::size_t size, double a, double * xys )
+     {
+      __m256d va {_mm256_set1_pd(a)} ;
+      std::size_t i {0} ;
+      for ( ; i+4<=2*size ; i+=4 )
+       {
+        __m256d v {_mm256_loadu_pd(xys+i)} ;
+        __m256d r {_mm256_add_pd(_mm256_mul_pd(va,_mm256_movedup_pd(v)),v)} ;
+        _mm256_storeu_pd(xys+i,_mm256_blend_pd(v,r,0b1010)) ;
+       }
+      scalar::saxpy_xy(size-i/2,a,xys+i) ;
+     }
+
+    __attribute__((target("avx2")))
+    inline double sum_y( std::size_t size, double const * xys )
+     {
+      __m256d acc {_mm256_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+4<=2*size ; i+=4 )
+        acc = _mm256_add_pd(acc,_mm256_loadu_pd(xys+i)) ;
+      __m128d s {_mm_add_pd(_mm256_castpd256_pd128(acc),_mm256_extractf128_pd(acc,1))} ;
+      return _mm_cvtsd_f64(_mm_unpackhi_pd(s,s)) + scalar::sum_y(size-i/2,xys+i) ;
+     }
+
+   }
+
+  //=====================================================
+  // AVX-512 : 8 doubles per register
+  //=====================================================
+
+  namespace avx512
+   {
+
+    __attribute__((target("avx512f")))
+    inline double hsum( __m512d v )
+     {
+      alignas(64) double lanes[8] ;
+      _mm512_store_pd(lanes,v) ;
+      return ((lanes[0]+lanes[1])+(lanes[2]+lanes[3]))+((lanes[4]+lanes[5])+(lanes[6]+lanes[7])) ;
+     }
+
+    __attribute__((target("avx512f")))
+    inline void saxpy( std::size_t size, double a, double const * xs, double * ys )
+     {
+      __m512d va {_mm512_set1_pd(a)} ;
+      std::size_t i {0} ;
+      for ( ; i+8<=size ; i+=8 )
+        _mm512_storeu_pd(ys+i,_mm512_add_pd(_mm512_mul_pd(va,_mm512_loadu_pd(xs+i)),_mm512_loadu_pd(ys+i))) ;
+      scalar::saxpy(size-i,a,xs+i,ys+i) ;
+     }
+
+    __attribute__((target("avx512f")))
+    inline void axpby( std::size_t size, double a, double const * xs, double b, double * ys )
+     {
+      __m512d va {_mm512_set1_pd(a)}, vb {_mm512_set1_pd(b)} ;
+      std::size_t i {0} ;
+      for ( ; i+8<=size ; i+=8 )
+        _mm512_storeu_pd(ys+i,_mm512_add_pd(_mm512_mul_pd(va,_mm512_loadu_pd(xs+i)),_mm512_mul_pd(vb,_mm512_loadu_pd(ys+i)))) ;
+      scalar::axpby(size-i,a,xs+i,b,ys+i) ;
+     }
+
+    __attribute__((target("avx512f")))
+    inline double dot( std::size_t size, double const * xs, double const * ys )
+     {
+      __m512d acc {_mm512_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+8<=size ; i+=8 )
+        acc = _mm512_add_pd(acc,_mm512_mul_pd(_mm512_loadu_pd(xs+i),_mm512_loadu_pd(ys+i))) ;
+      return hsum(acc) + scalar::dot(size-i,xs+i,ys+i) ;
+     }
+
+    __attribute__((target("avx512f")))
+    inline double sum( std::size_t size, double const * xs )
+     {
+      __m512d acc {_mm512_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+8<=size ; i+=8 )
+        acc = _mm512_add_pd(acc,_mm512_loadu_pd(xs+i)) ;
+      return hsum(acc) + scalar::sum(size-i,xs+i) ;
+     }
+
+    // four {x,y} pairs per register, odd lanes updated with a mask
+    __attribute__((target("avx512f")))
+    inline void saxpy_xy( std::size_t size, double a, double * xys )
+     {
+      __m512d va {_mm512_set1_pd(a)} ;
+      std::size_t i {0} ;
+      for ( ; i+8<=2*size ; i+=8 )
+       {
+        __m512d v {_mm512_loadu_pd(xys+i)} ;
+        __m512d r {_mm512_add_pd(_mm512_mul_pd(va,_mm512_maskz_unpacklo_pd(0xFF,v,v)),v)} ;
+        _mm512_storeu_pd(xys+i,_mm512_mask_blend_pd(0b10101010,v,r)) ;
+       }
+      scalar::saxpy_xy(size-i/2,a,xys+i) ;
+     }
+
+    __attribute__((target("avx512f")))
+    inline double sum_y( std::size_t size, double const * xys )
+     {
+      __m512d acc {_mm512_setzero_pd()} ;
+      std::size_t i {0} ;
+      for ( ; i+8<=2*size ; i+=8 )
+        acc = _mm512_mask_add_pd(acc,0b10101010,acc,_mm512_loadu_pd(xys+i)) ;
+      return hsum(acc) + scalar::sum_y(size-i/2,xys+i) ;
+     }
+
+   }
+
+#endif
+
+  //=====================================================
+  // runtime dispatch
+  //=====================================================
+
+  struct Kernels
+   {
+    std::string_view name ;
+    void (*saxpy)( std::size_t, double, double const *, double * ) ;
+    void (*axpby)( std::size_t, double, double const *, double, double * ) ;
+    double (*dot)( std::size_t, double const *, double const * ) ;
+    double (*sum)( std::size_t, double const * ) ;
+    void (*saxpy_xy)( std::size_t, double, double * ) ;
+    double (*sum_y)( std::size_t, double const * ) ;
+   } ;
+
+  inline constexpr Kernels scalar_kernels
+   { "scalar", scalar::saxpy, scalar::axpby, scalar::dot, scalar::sum, scalar::saxpy_xy, scalar::sum_y } ;
+#ifdef SIMD_KERNELS_X86
+  inline constexpr Kernels sse2_kernels
+   { "sse2", sse2::saxpy, sse2::axpby, sse2::dot, sse2::sum, sse2::saxpy_xy, sse2::sum_y } ;
+  inline constexpr Kernels avx2_kernels
+   { "avx2", avx2::saxpy, avx2::axpby, avx2::dot, avx2::sum, avx2::saxpy_xy, avx2::sum_y } ;
+  inline constexpr Kernels avx512_kernels
+   { "avx512", avx512::saxpy, avx512::axpby, avx512::dot, avx512::sum, avx512::saxpy_xy, avx512::sum_y } ;
+#endif
+
+  // is the given instruction set usable on this CPU
+  inline bool supported( std::string_view isa )
+   {
+    if (isa=="scalar") return true ;
+#ifdef SIMD_KERNELS_X86
+    __builtin_cpu_init() ;
+    if (isa=="sse2") return __builtin_cpu_supports("sse2") ;
+    if (isa=="avx2") return __builtin_cpu_supports("avx2") ;
+    if (isa=="avx512") return __builtin_cpu_supports("avx512f") ;
+#endif
+    return false ;
+   }
+
+  // best kernels for this CPU, detected once
+  inline Kernels const & best_kernels()
+   {
+    static Kernels const & best = []() -> Kernels const &
+     {
+#ifdef SIMD_KERNELS_X86
+      if (supported("avx512")) return avx512_kernels ;
+      if (supported("avx2")) return avx2_kernels ;
+      if (supported("sse2")) return sse2_kernels ;
+#endif
+      return scalar_kernels ;
+     }() ;
+    return best ;
+   }
+
+  // kernels for a name among auto|scalar|sse2|avx2|avx512 ;
+  // throws if the name is unknown or not supported by this CPU
+  inline Kernels const & select_kernels( std::string_view isa )
+   {
+    if (isa=="auto") return best_kernels() ;
+    if ((isa!="scalar")&&(isa!="sse2")&&(isa!="avx2")&&(isa!="avx512"))
+      throw std::runtime_error("unknown kernel: "+std::string(isa)) ;
+    if (!supported(isa))
+      throw std::runtime_error("kernel not available on this CPU: "+std::string(isa)) ;
+#ifdef SIMD_KERNELS_X86
+    if (isa=="sse2") return sse2_kernels ;
+    if (isa=="avx2") return avx2_kernels ;
+    if (isa=="avx512") return avx512_kernels ;
+#endif
+    return scalar_kernels ;
+   }
+
+ }
+
+#pragma GCC pop_options
+
+#endif
@@ -0,0 +1,230 @@
+#include "soa-aligned.h"
+#include "simd-kernels.h"
+#include "thread-pool.h"
+#include "reduction.h"
+#include "arrays-options.h"
+#include "tiling.h"
+#include <iostream>
+#include <cassert> // for assert
+#include <cstdlib> // for rand
+#include <memory> // for std::assume_aligned
+#include <optional>
+#include <vector>
+#include <format>
+
+struct XY
+ { double x, y {0.} ; } ;
+
+using SoA = AlignedSoA<XY,&XY::x,&XY::y> ;
+
+void randomize_x( SoA & collection )
+ {
+  srand(1) ;
+  double * xs {collection.data<&XY::x>()} ;
+  for ( std::size_t i=0 ; i<collection.size() ; ++i )
+   { xs[i] = std::rand()/(RAND_MAX+1.)-0.5 ; }
+ }
+
+// saxpy on the indices [begin,end), which must be multiples of SoA::lanes ;
+// once told that the pointers are aligned and that the size is a multiple
+// of the lanes, the compiler has neither a peel nor a remainder to generate
+void saxpy( SoA & collection, double a, std::size_t begin, std::size_t end )
+ {
+  double const * __restrict__ xs {std::assume_aligned<soa_alignment>(collection.data<&XY::x>()+begin)} ;
+  double * __restrict__ ys {std::assume_aligned<soa_alignment>(collection.data<&XY::y>()+begin)} ;
+  std::size_t size {(end-begin)/SoA::lanes*SoA::lanes} ;
+  for ( std::size_t i=0 ; i<size ; ++i )
+    ys[i] = a*xs[i] + ys[i] ;
+ }
+
+void saxpy( simd::Kernels const & kernels, SoA & collection, double a, std::size_t begin, std::size_t end )
+ { kernels.saxpy(end-begin,a,collection.data<&XY::x>()+begin,collection.data<&XY::y>()+begin) ; }
+
+double accumulate_y( SoA const & collection, std::size_t begin, std::size_t end )
+ {
+  double res {0.} ;
+  double const * ys {collection.data<&XY::y>()} ;
+  for ( std::size_t i=begin ; i<end ; ++i )
+   { res += ys[i] ; }
+  return res ;
+ }
+
+double accumulate_y( simd::Kernels const & kernels, SoA const & collection, std::size_t begin, std::size_t end )
+ { return kernels.sum(end-begin,collection.data<&XY::y>()+begin) ; }
+
+// whole collection
+
+void saxpy( SoA & collection, double a )
+ { saxpy(collection,a,0,collection.padded_size()) ; }
+
+void saxpy( simd::Kernels const & kernels, SoA & collection, double a )
+ { saxpy(kernels,collection,a,0,collection.padded_size()) ; }
+
+double accumulate_y( SoA const & collection )
+ { return accumulate_y(collection,0,collection.size()) ; }
+
+double accumulate_y( simd::Kernels const & kernels, SoA const & collection )
+ { return accumulate_y(kernels,collection,0,collection.size()) ; }
+
+// cache blocking on [begin,end) ; tile must be a multiple of SoA::lanes
+template< typename... Kernels >
+void tiled_saxpy
+ ( SoA & collection, double const volatile & a, std::size_t repeat, std::size_t tile,
+   std::size_t begin, std::size_t end, Kernels const & ... kernels )
+ {
+  repeat_saxpy(begin,end,tile,repeat,[&]( std::size_t first, std::size_t last )
+   { saxpy(kernels...,collection,a,first,last) ; }) ;
+ }
+
+void repeat_saxpy( SoA & collection, double const volatile & a, std::size_t repeat, std::size_t tile )
+ { tiled_saxpy(collection,a,repeat,tile,0,collection.padded_size()) ; }
+
+void repeat_saxpy
+ ( simd::Kernels const & kernels, SoA & collection, double const volatile & a,
+   std::size_t repeat, std::size_t tile )
+ { tiled_saxpy(collection,a,repeat,tile,0,collection.padded_size(),kernels) ; }
+
+// multithreaded : each worker always processes the same slice, which it
+// has first-touched itself, so that its pages are on the worker NUMA node
+
+std::pair<std::size_t,std::size_t> worker_slice( ThreadPool const & pool, std::size_t num, SoA const & collection )
+ { return slice(num,pool.size(),collection.padded_size(),SoA::lanes) ; }
+
+void first_touch( ThreadPool & pool, SoA & collection )
+ {
+  pool.run([&]( std::size_t num )
+   {
+    auto [begin,end] = worker_slice(pool,num,collection) ;
+    collection.zero(begin,end) ;
+   }) ;
+ }
+
+void saxpy( ThreadPool & pool, SoA & collection, double a )
+ {
+  pool.run([&]( std::size_t num )
+   {
+    auto [begin,end] = worker_slice(pool,num,collection) ;
+    saxpy(collection,a,begin,end) ;
+   }) ;
+ }
+
+void saxpy( ThreadPool & pool, simd::Kernels const & kernels, SoA & collection, double a )
+ {
+  pool.run([&]( std::size_t num )
+   {
+    auto [begin,end] = worker_slice(pool,num,collection) ;
+    saxpy(kernels,collection,a,begin,end) ;
+   }) ;
+ }
+
+// the partial sums are added in the order of the workers,
+// so that the result only depends on the number of threads
+template< typename... Kernels >
+double parallel_accumulate_y( ThreadPool & pool, SoA const & collection, Kernels const & ... kernels )
+ {
+  std::vector<double> partials(pool.size()) ;
+  pool.run([&]( std::size_t num )
+   {
+    auto [begin,end] = worker_slice(pool,num,collection) ;
+    if (end>collection.size()) end = collection.size() ;
+    if (begin>end) begin = end ;
+    partials[num] = accumulate_y(kernels...,collection,begin,end) ;
+   }) ;
+  double res {0.} ;
+  for ( double partial : partials )
+   { res += partial ; }
+  return res ;
+ }
+
+// with tiles, each worker needs no synchronization at all between repetitions
+void repeat_saxpy
+ ( ThreadPool & pool, SoA & collection, double const volatile & a,
+   std::size_t repeat, std::size_t tile )
+ {
+  pool.run([&]( std::size_t num )
+   {
+    auto [begin,end] = worker_slice(pool,num,collection) ;
+    tiled_saxpy(collection,a,repeat,tile,begin,end) ;
+   }) ;
+ }
+
+void repeat_saxpy
+ ( ThreadPool & pool, simd::Kernels const & kernels, SoA & collection, double const volatile & a,
+   std::size_t repeat, std::size_t tile )
+ {
+  pool.run([&]( std::size_t num )
+   {
+    auto [begin,end] = worker_slice(pool,num,collection) ;
+    tiled_saxpy(collection,a,repeat,tile,begin,end,kernels) ;
+   }) ;
+ }
+
+double accumulate_y( ThreadPool & pool, SoA const & collection )
+ { return parallel_accumulate_y(pool,collection) ; }
+
+double accumulate_y( ThreadPool & pool, simd::Kernels const & kernels, SoA const & collection )
+ { return parallel_accumulate_y(pool,collection,kernels) ; }
+
+// with a chosen summation algorithm, the result is the same whatever the
+// number of threads ; the simd kernels are not used, since the blocked
+// summation is already vectorized
+
+double accumulate_y( reduction::Summation summation, SoA const & collection, ThreadPool * pool = nullptr )
+ {
+  double const * ys {collection.data<&XY::y>()} ;
+  return reduction::reduce(summation,collection.size(),[ys]( std::size_t i ){ return ys[i] ; },pool) ;
+ }
+
+double accumulate_y( reduction::Summation summation, simd::Kernels const &, SoA const & collection )
+ { return accumulate_y(summation,collection) ; }
+
+double accumulate_y( reduction::Summation summation, ThreadPool & pool, SoA const & collection )
+ { return accumulate_y(summation,collection,&pool) ; }
+
+double accumulate_y( reduction::Summation summation, ThreadPool & pool, simd::Kernels const &, SoA const & collection )
+ { return accumulate_y(summation,collection,&pool) ; }
+
+int main( int argc, char * argv[] )
+ {
+  assert(argc>=3) ;
+  std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
+  std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t nb_threads {size_option(argc,argv,"threads")} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  tile = (tile+SoA::lanes-1)/SoA::lanes*SoA::lanes ;
+  std::optional<reduction::Summation> summation ;
+  if (!option(argc,argv,"sum").empty())
+    summation = select_option(argc,argv,"sum","naive|blocked|pairwise|neumaier",reduction::select_summation) ;
+
+  // context is empty, or a thread pool, and/or simd kernels
+  double volatile a {0.1} ;
+  auto compute = [&]( SoA & collection, auto & ... context )
+   {
+    if (tile==0)
+      for ( std::size_t r=0 ; r<repeat ; ++r )
+        saxpy(context...,collection,a) ;
+    else
+      repeat_saxpy(context...,collection,a,repeat,tile) ;
+    if (!summation) return accumulate_y(context...,collection)/size ;
+    return accumulate_y(*summation,context...,collection)/size ;
+   } ;
+
+  double res ;
+  if (nb_threads==0)
+   {
+    SoA collection(size) ;
+    randomize_x(collection) ;
+    res = with_kernels(argc,argv,[&]( auto const & ... kernels )
+     { return compute(collection,kernels...) ; }) ;
+   }
+  else
+   {
+    ThreadPool pool(nb_threads) ;
+    SoA collection(size,no_init) ;
+    first_touch(pool,collection) ;
+    randomize_x(collection) ;
+    res = with_kernels(argc,argv,[&]( auto const & ... kernels )
+     { return compute(collection,pool,kernels...) ; }) ;
+   }
+  std::cout<<std::format("{}",res)<<std::endl ;
+ }
@@ -0,0 +1,169 @@
+#ifndef SOA_ALIGNED_H
+#define SOA_ALIGNED_H
+
+#include <algorithm> // for std::min
+#include <cstddef> // for std::size_t
+#include <cstdlib> // for std::aligned_alloc & std::free
+#include <cstring> // for std::memcpy
+#include <memory> // for std::unique_ptr & std::assume_aligned
+#include <new> // for std::bad_alloc
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// all the buffers start on a cache line, and are padded up to a full
+// cache line, so that vectorized loops never need a peel or a remainder
+constexpr std::size_t soa_alignment {64} ;
+
+// tag to skip the zero-initialization of the buffers, typically so that
+// each thread can first-touch its own part of the memory (see zero())
+struct NoInit {} ;
+constexpr NoInit no_init {} ;
+
+// type of a data member, from a pointer to this member
+template< typename M >
+struct member_traits ;
+
+template< typename S, typename F >
+struct member_traits<F S::*>
+ {
+  using struct_type = S ;
+  using field_type = F ;
+ } ;
+
+template< auto Member >
+using field_t = typename member_traits<decltype(Member)>::field_type ;
+
+// one aligned and padded array of values
+template< typename T >
+class AlignedBuffer
+ {
+  public :
+
+    static_assert(std::is_trivially_copyable_v<T>) ;
+    static_assert((soa_alignment%sizeof(T))==0) ;
+
+    AlignedBuffer( std::size_t padded_size )
+     : m_size{padded_size}, m_data{allocate(padded_size)}
+     { zero(0,m_size) ; }
+    AlignedBuffer( std::size_t padded_size, NoInit )
+     : m_size{padded_size}, m_data{allocate(padded_size)}
+     {}
+    AlignedBuffer( AlignedBuffer const & other )
+     : m_size{other.m_size}, m_data{allocate(other.m_size)}
+     { std::memcpy(m_data.get(),other.m_data.get(),m_size*sizeof(T)) ; }
+    AlignedBuffer( AlignedBuffer && ) = default ;
+    AlignedBuffer & operator=( AlignedBuffer const & other )
+     { AlignedBuffer tmp {other} ; return (*this = std::move(tmp)) ; }
+    AlignedBuffer & operator=( AlignedBuffer && ) = default ;
+
+    T * data() { return std::assume_aligned<soa_alignment>(m_data.get()) ; }
+    T const * data() const { return std::assume_aligned<soa_alignment>(m_data.get()) ; }
+
+    void zero( std::size_t begin, std::size_t end )
+     { for ( std::size_t i=begin ; i<end ; ++i ) m_data[i] = T{} ; }
+
+  private :
+
+    struct Free
+     { void operator()( T * ptr ) const { std::free(ptr) ; } } ;
+
+    static T * allocate( std::size_t padded_size )
+     {
+      std::size_t bytes {padded_size*sizeof(T)} ;
+      if (bytes==0) bytes = soa_alignment ;
+      void * ptr {std::aligned_alloc(soa_alignment,bytes)} ;
+      if (ptr==nullptr) throw std::bad_alloc() ;
+      return static_cast<T *>(ptr) ;
+     }
+
+    std::size_t m_size ;
+    std::unique_ptr<T[],Free> m_data ;
+ } ;
+
+// generic SoA for the struct S, which stores each of the given data
+// members of S in its own aligned buffer, e.g. AlignedSoA<XY,&XY::x,&XY::y>
+template< typename S, auto... Members >
+class AlignedSoA
+ {
+  public :
+
+    static_assert(sizeof...(Members)>0) ;
+    static_assert((std::is_same_v<typename member_traits<decltype(Members)>::struct_type,S> && ...)) ;
+
+    // number of elements of the smallest field in a cache line,
+    // the padded size is always a multiple of this
+    static constexpr std::size_t lanes {soa_alignment/std::min({sizeof(field_t<Members>)...})} ;
+
+    // proxy to the element at a given indice
+    class Reference
+     {
+      public :
+        Reference( AlignedSoA & soa, std::size_t indice ) : m_soa{soa}, m_indice{indice} {}
+        operator S() const { return std::as_const(m_soa)(m_indice) ; }
+        Reference & operator=( S const & s )
+         { ((m_soa.template data<Members>()[m_indice] = s.*Members), ...) ; return *this ; }
+        template< auto Member >
+        field_t<Member> & get() const { return m_soa.template data<Member>()[m_indice] ; }
+      private :
+        AlignedSoA & m_soa ;
+        std::size_t m_indice ;
+     } ;
+
+    AlignedSoA( std::size_t size )
+     : m_size{size}, m_padded_size{(size+lanes-1)/lanes*lanes},
+       m_fields{AlignedBuffer<field_t<Members>>(m_padded_size)...}
+     {}
+    AlignedSoA( std::size_t size, NoInit )
+     : m_size{size}, m_padded_size{(size+lanes-1)/lanes*lanes},
+       m_fields{AlignedBuffer<field_t<Members>>(m_padded_size,no_init)...}
+     {}
+
+    std::size_t size() const { return m_size ; }
+    std::size_t padded_size() const { return m_padded_size ; }
+
+    S operator()( std::size_t indice ) const
+     {
+      S res {} ;
+      ((res.*Members = data<Members>()[indice]), ...) ;
+      return res ;
+     }
+    Reference operator[]( std::size_t indice )
+     { return { *this, indice } ; }
+
+    // zero-initialize the indices [begin,end) of all the buffers
+    void zero( std::size_t begin, std::size_t end )
+     { std::apply([=]( auto & ... buffers ){ (buffers.zero(begin,end), ...) ; },m_fields) ; }
+
+    // raw aligned access to the buffer of a given member ; the elements
+    // beyond size() and up to padded_size() are zero-initialized padding
+    template< auto Member >
+    field_t<Member> * data()
+     { return std::get<index_of<Member>()>(m_fields).data() ; }
+    template< auto Member >
+    field_t<Member> const * data() const
+     { return std::get<index_of<Member>()>(m_fields).data() ; }
+
+  private :
+
+    template< auto M1, auto M2 >
+    static constexpr bool same_member()
+     {
+      if constexpr (std::is_same_v<decltype(M1),decltype(M2)>) return (M1==M2) ;
+      else return false ;
+     }
+
+    template< auto Member >
+    static constexpr std::size_t index_of()
+     {
+      std::size_t indice {0}, res {sizeof...(Members)} ;
+      ((same_member<Member,Members>() ? (res = indice) : 0, ++indice), ...) ;
+      return res ;
+     }
+
+    std::size_t m_size ;
+    std::size_t m_padded_size ;
+    std::tuple<AlignedBuffer<field_t<Members>>...> m_fields ;
+ } ;
+
+#endif
@@ -1,3 +1,6 @@
+#include "simd-kernels.h"
+#include "arrays-options.h"
+#include "tiling.h"
 #include <iostream>
 #include <cassert> // for assert
 #include <cstdlib> // for rand
@@ -21,6 +24,15 @@ class SoA
       for ( std::size_t i=0 ; i<m_size ; ++i )
         m_ys[i] = a*m_xs[i] + m_ys[i] ;
      }
+    void saxpy( double a, std::size_t begin, std::size_t end )
+     {
+      for ( std::size_t i=begin ; i<end ; ++i )
+        m_ys[i] = a*m_xs[i] + m_ys[i] ;
+     }
+    void saxpy( simd::Kernels const & kernels, double a )
+     { kernels.saxpy(m_size,a,m_xs,m_ys) ; }
+    void saxpy( simd::Kernels const & kernels, double a, std::size_t begin, std::size_t end )
+     { kernels.saxpy(end-begin,a,m_xs+begin,m_ys+begin) ; }
   private :
     std::size_t m_size ;
     double * __restrict__ m_xs ;
@@ -42,17 +54,25 @@ double accumulate_y( SoA & collection )
   return res ;
  }
 
+double accumulate_y( simd::Kernels const & kernels, SoA & collection )
+ { return kernels.sum(collection.size(),collection.ys()) ; }
+
 int main( int argc, char * argv[] )
  {
-  assert(argc==3) ;
+  assert(argc>=3) ;
   std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
   std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
 
   SoA collection(size) ;
   randomize_x(collection) ;
   double volatile a {0.1} ;
-  while (repeat--)
-    collection.saxpy(a) ;
-  double res = accumulate_y(collection)/size ;
+  double res {with_kernels(argc,argv,[&]( auto const & ... kernels )
+   {
+    repeat_saxpy(std::size_t{0},collection.size(),tile,repeat,
+      [&]( std::size_t first, std::size_t last ){ collection.saxpy(kernels...,a,first,last) ; },
+      [&]{ collection.saxpy(kernels...,a) ; }) ;
+    return accumulate_y(kernels...,collection)/size ;
+   })} ;
   std::cout<<std::format("{}",res)<<std::endl ;
  }
@@ -0,0 +1,92 @@
+#include "colony.h"
+#include "arrays-options.h"
+#include "tiling.h"
+#include <iostream>
+#include <cassert> // for assert
+#include <cstdlib> // for rand
+#include <algorithm> // for std::min
+#include <format>
+
+struct XY
+ { double x, y {0.} ; } ;
+
+// the x and y of an element always have the same slot in both colonies,
+// which stays valid until the element is erased
+class SoA
+ {
+  public :
+    static constexpr std::size_t block_size {Colony<double>::block_size} ;
+    SoA( std::size_t size ) : m_xs(size), m_ys(size) {}
+    std::size_t slots() const { return m_xs.slots() ; }
+    XY operator()( std::size_t slot ) const
+     { return { m_xs[slot], m_ys[slot] } ; }
+    std::size_t insert( XY const & xy )
+     {
+      m_ys.insert(xy.y) ;
+      return m_xs.insert(xy.x) ;
+     }
+    void erase( std::size_t slot )
+     {
+      m_xs.erase(slot) ;
+      m_ys.erase(slot) ;
+     }
+    auto & xs() { return m_xs ; }
+    auto & ys() { return m_ys ; }
+    // saxpy on the slots [begin,end), one contiguous block after the other ;
+    // the dead slots are computed as well, since nobody reads them
+    void saxpy( double a, std::size_t begin, std::size_t end )
+     {
+      while (begin<end)
+       {
+        std::size_t num {begin/block_size} ;
+        std::size_t offset {begin%block_size} ;
+        std::size_t count {std::min(end-begin,block_size-offset)} ;
+        double const * xs {m_xs.block(num).data()+offset} ;
+        double * ys {m_ys.block(num).data()+offset} ;
+        for ( std::size_t i=0 ; i<count ; ++i )
+          ys[i] = a*xs[i] + ys[i] ;
+        begin += count ;
+       }
+     }
+    void saxpy( double a )
+     { saxpy(a,0,slots()) ; }
+  private :
+    Colony<double> m_xs ;
+    Colony<double> m_ys ;
+ } ;
+
+void randomize_x( SoA & collection )
+ {
+  srand(1) ;
+  for ( auto & element : collection.xs() )
+   { element = std::rand()/(RAND_MAX+1.)-0.5 ; }
+ }
+
+double accumulate_y( SoA & collection )
+ {
+  double res {0.} ;
+  collection.ys().for_each_block([&res]( double const * ys, std::size_t count )
+   {
+    for ( std::size_t i=0 ; i<count ; ++i )
+      res += ys[i] ;
+   }) ;
+  return res ;
+ }
+
+int main( int argc, char * argv[] )
+ {
+  assert(argc>=3) ;
+  std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
+  std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  reject_kernels(argc,argv) ;
+
+  SoA collection(size) ;
+  randomize_x(collection) ;
+  double volatile a {0.1} ;
+  repeat_saxpy(std::size_t{0},collection.slots(),tile,repeat,
+    [&]( std::size_t first, std::size_t last ){ collection.saxpy(a,first,last) ; },
+    [&]{ collection.saxpy(a) ; }) ;
+  double res = accumulate_y(collection)/size ;
+  std::cout<<std::format("{}",res)<<std::endl ;
+ }
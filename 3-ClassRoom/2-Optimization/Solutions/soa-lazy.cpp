@@ -0,0 +1,85 @@
+#include "simd-kernels.h"
+#include "arrays-options.h"
+#include "tiling.h"
+#include "lazy-array.h"
+#include <iostream>
+#include <cassert> // for assert
+#include <cstdlib> // for rand
+#include <functional> // for std::plus & std::multiplies
+#include <type_traits> // for std::is_same_v
+#include <format>
+
+struct XY
+ { double x, y {0.} ; } ;
+
+class SoA
+ {
+  public :
+    SoA( std::size_t size ) : m_xs(size), m_ys(size) {}
+    std::size_t size() { return m_xs.size() ; }
+    XY operator()( std::size_t indice ) const
+     { return { m_xs[indice], m_ys[indice] } ; }
+    auto & xs() { return m_xs ; }
+    auto & ys() { return m_ys ; }
+    // one single fused loop, without any temporary array : the right
+    // hand side is a tree of nodes, evaluated by the assignment only
+    void saxpy( double a )
+     {
+      auto expression {a*m_xs + m_ys} ;
+      using Saxpy = lazy::Binary<std::plus<>,
+        lazy::Binary<std::multiplies<>,lazy::Scalar<double>,lazy::View<double>>,
+        lazy::View<double>> ;
+      static_assert(std::is_same_v<decltype(expression),Saxpy>) ;
+      m_ys = expression ;
+     }
+    void saxpy( double a, std::size_t begin, std::size_t end )
+     {
+      for ( std::size_t i=begin ; i<end ; ++i )
+        m_ys[i] = a*m_xs[i] + m_ys[i] ;
+     }
+    void saxpy( simd::Kernels const & kernels, double a )
+     { kernels.saxpy(m_xs.size(),a,std::begin(m_xs),std::begin(m_ys)) ; }
+    void saxpy( simd::Kernels const & kernels, double a, std::size_t begin, std::size_t end )
+     { kernels.saxpy(end-begin,a,std::begin(m_xs)+begin,std::begin(m_ys)+begin) ; }
+  private :
+    lazy::Array<double> m_xs ;
+    lazy::Array<double> m_ys ;
+ } ;
+
+void randomize_x( SoA & collection )
+ {
+  srand(1) ;
+  for ( auto & element : collection.xs() )
+   { element = std::rand()/(RAND_MAX+1.)-0.5 ; }
+ }
+
+double accumulate_y( SoA & collection )
+ {
+  double res {0.} ;
+  for ( auto element : collection.ys() )
+   { res += element ; }
+  return res ;
+ }
+
+double accumulate_y( simd::Kernels const & kernels, SoA & collection )
+ { return kernels.sum(collection.ys().size(),std::begin(collection.ys())) ; }
+
+int main( int argc, char * argv[] )
+ {
+  assert(argc>=3) ;
+  std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
+  std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+
+  SoA collection(size) ;
+  randomize_x(collection) ;
+  double volatile a {0.1} ;
+  double res {with_kernels(argc,argv,[&]( auto const & ... kernels )
+   {
+    repeat_saxpy(std::size_t{0},collection.size(),tile,repeat,
+      [&]( std::size_t first, std::size_t last ){ collection.saxpy(kernels...,a,first,last) ; },
+      [&]{ collection.saxpy(kernels...,a) ; }) ;
+    return accumulate_y(kernels...,collection)/size ;
+   })} ;
+  std::cout<<std::format("{}",res)<<std::endl ;
+ }
@@ -1,8 +1,11 @@
+#include "arrays-options.h"
+#include "tiling.h"
 #include <iostream>
 #include <cassert> // for assert
 #include <cstdlib> // for rand
 #include <list>
 #include <format>
+#include <iterator> // for std::advance
 
 struct XY
  { double x, y {0.} ; } ;
@@ -10,7 +13,9 @@ struct XY
 class SoA
  {
   public :
-    SoA( std::size_t size ) : m_xs(size), m_ys(size) {}
+    SoA( std::size_t size )
+     : m_xs(size), m_ys(size), m_first_xs{m_xs.begin()}, m_first_ys{m_ys.begin()} {}
+    std::size_t size() const { return m_xs.size() ; }
     XY operator()( std::size_t indice ) const
      {
       auto xs = m_xs.begin() ;
@@ -28,9 +33,31 @@ class SoA
       for ( ; xs != end ; ++xs, ++ys )
         (*ys) = a*(*xs) + (*ys) ;
      }
+    // the lists have no random access : the iterators of the beginning
+    // of the last range are kept, so that the ranges given in order, as
+    // the tiles are, only walk each element once more
+    void saxpy( double a, std::size_t begin, std::size_t end )
+     {
+      if (begin<m_first)
+       {
+        m_first = 0 ;
+        m_first_xs = m_xs.begin() ;
+        m_first_ys = m_ys.begin() ;
+       }
+      std::advance(m_first_xs,begin-m_first) ;
+      std::advance(m_first_ys,begin-m_first) ;
+      m_first = begin ;
+      auto xs = m_first_xs ;
+      auto ys = m_first_ys ;
+      for ( std::size_t i=begin ; i<end ; ++i, ++xs, ++ys )
+        (*ys) = a*(*xs) + (*ys) ;
+     }
   private :
     std::list<double> m_xs ;
     std::list<double> m_ys ;
+    std::size_t m_first {0} ;
+    std::list<double>::iterator m_first_xs ;
+    std::list<double>::iterator m_first_ys ;
  } ;
 
 void randomize_x( SoA & collection )
@@ -50,15 +77,18 @@ double accumulate_y( SoA & collection )
 
 int main( int argc, char * argv[] )
  {
-  assert(argc==3) ;
+  assert(argc>=3) ;
   std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
   std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
+  reject_kernels(argc,argv) ;
 
   SoA collection(size) ;
   randomize_x(collection) ;
   double volatile a {0.1} ;
-  while (repeat--)
-    collection.saxpy(a) ;
+  repeat_saxpy(std::size_t{0},collection.size(),tile,repeat,
+    [&]( std::size_t first, std::size_t last ){ collection.saxpy(a,first,last) ; },
+    [&]{ collection.saxpy(a) ; }) ;
   double res = accumulate_y(collection)/size ;
   std::cout<<std::format("{}",res)<<std::endl ;
  }
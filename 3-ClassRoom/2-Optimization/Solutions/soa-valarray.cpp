@@ -1,3 +1,6 @@
+#include "simd-kernels.h"
+#include "arrays-options.h"
+#include "tiling.h"
 #include <iostream>
 #include <cassert> // for assert
 #include <cstdlib> // for rand
@@ -11,12 +14,22 @@ class SoA
  {
   public :
     SoA( std::size_t size ) : m_xs(size), m_ys(size) {}
+    std::size_t size() { return m_xs.size() ; }
     XY operator()( std::size_t indice ) const
      { return { m_xs[indice], m_ys[indice] } ; }
     auto & xs() { return m_xs ; }
     auto & ys() { return m_ys ; }
     void saxpy( double a )
      { m_ys = a*m_xs + m_ys ; }
+    void saxpy( double a, std::size_t begin, std::size_t end )
+     {
+      for ( std::size_t i=begin ; i<end ; ++i )
+        m_ys[i] = a*m_xs[i] + m_ys[i] ;
+     }
+    void saxpy( simd::Kernels const & kernels, double a )
+     { kernels.saxpy(m_xs.size(),a,std::begin(m_xs),std::begin(m_ys)) ; }
+    void saxpy( simd::Kernels const & kernels, double a, std::size_t begin, std::size_t end )
+     { kernels.saxpy(end-begin,a,std::begin(m_xs)+begin,std::begin(m_ys)+begin) ; }
   private :
     std::valarray<double> m_xs ;
     std::valarray<double> m_ys ;
@@ -37,17 +50,25 @@ double accumulate_y( SoA & collection )
   return res ;
  }
 
+double accumulate_y( simd::Kernels const & kernels, SoA & collection )
+ { return kernels.sum(collection.ys().size(),std::begin(collection.ys())) ; }
+
 int main( int argc, char * argv[] )
  {
-  assert(argc==3) ;
+  assert(argc>=3) ;
   std::size_t size {std::strtoull(argv[1],nullptr,10)} ;
   std::size_t repeat {std::strtoull(argv[2],nullptr,10)} ;
+  std::size_t tile {size_option(argc,argv,"tile")} ;
 
   SoA collection(size) ;
   randomize_x(collection) ;
   double volatile a {0.1} ;
-  while (repeat--)
-    collection.saxpy(a) ;
-  double res = accumulate_y(collection)/size ;
+  double res {with_kernels(argc,argv,[&]( auto const & ... kernels )
+   {
+    repeat_saxpy(std::size_t{0},collection.size(),tile,repeat,
+      [&]( std::size_t first, std::size_t last ){ collection.saxpy(kernels...,a,first,last) ; },
+      [&]{ collection.saxpy(kernels...,a) ; }) ;
+    return accumulate_y(kernels...,collection)/size ;
+   })} ;
   std::cout<<std::format("{}",res)<<std::endl ;
  }
@@ -0,0 +1,123 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef> // for std::size_t
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility> // for std::pair
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// pin the calling thread on the num-th cpu it is allowed to run on
+// (modulo the number of such cpus), and return false if not possible
+inline bool pin_to_cpu( std::size_t num )
+ {
+#ifdef __linux__
+  cpu_set_t allowed ;
+  if (sched_getaffinity(0,sizeof(allowed),&allowed)!=0) return false ;
+  std::size_t nb_allowed = CPU_COUNT(&allowed) ;
+  if (nb_allowed==0) return false ;
+  num %= nb_allowed ;
+  for ( int cpu=0 ; cpu<CPU_SETSIZE ; ++cpu )
+   {
+    if (!CPU_ISSET(cpu,&allowed)) continue ;
+    if (num--!=0) continue ;
+    cpu_set_t target ;
+    CPU_ZERO(&target) ;
+    CPU_SET(cpu,&target) ;
+    return (pthread_setaffinity_np(pthread_self(),sizeof(target),&target)==0) ;
+   }
+#endif
+  return false ;
+ }
+
+// indices [begin,end) of the part num among nb of [0,size), cut
+// on multiples of block, so that two threads never share a cache line
+inline std::pair<std::size_t,std::size_t> slice
+ ( std::size_t num, std::size_t nb, std::size_t size, std::size_t block = 1 )
+ {
+  std::size_t nb_blocks {(size+block-1)/block} ;
+  std::size_t begin {nb_blocks*num/nb*block} ;
+  std::size_t end {nb_blocks*(num+1)/nb*block} ;
+  return { (begin<size)?begin:size, (end<size)?end:size } ;
+ }
+
+// persistent pool of threads, each pinned on its own cpu ;
+// run(job) calls job(num_worker) in every worker, and waits for all of them
+class ThreadPool
+ {
+  public :
+
+    explicit ThreadPool( std::size_t nb_workers )
+     {
+      for ( std::size_t num=0 ; num<nb_workers ; ++num )
+        m_workers.emplace_back(&ThreadPool::work,this,num) ;
+     }
+
+    ThreadPool( ThreadPool const & ) = delete ;
+    ThreadPool & operator=( ThreadPool const & ) = delete ;
+
+    ~ThreadPool()
+     {
+       {
+        std::scoped_lock<std::mutex> lock(m_mutex) ;
+        m_stop = true ;
+       }
+      m_wake.notify_all() ;
+      for ( auto & worker : m_workers )
+       { worker.join() ; }
+     }
+
+    std::size_t size() const { return m_workers.size() ; }
+
+    void run( std::function<void(std::size_t)> const & job )
+     {
+      std::unique_lock<std::mutex> lock(m_mutex) ;
+      m_job = &job ;
+      m_pending = m_workers.size() ;
+      ++m_generation ;
+      m_wake.notify_all() ;
+      m_done.wait(lock,[this]{ return m_pending==0 ; }) ;
+      m_job = nullptr ;
+     }
+
+  private :
+
+    void work( std::size_t num )
+     {
+      pin_to_cpu(num) ;
+      std::size_t generation {0} ;
+      while (true)
+       {
+        std::function<void(std::size_t)> const * job ;
+         {
+          std::unique_lock<std::mutex> lock(m_mutex) ;
+          m_wake.wait(lock,[&]{ return m_stop || (m_generation!=generation) ; }) ;
+          if (m_stop) return ;
+          generation = m_generation ;
+          job = m_job ;
+         }
+        (*job)(num) ;
+         {
+          std::scoped_lock<std::mutex> lock(m_mutex) ;
+          if (--m_pending==0) m_done.notify_one() ;
+         }
+       }
+     }
+
+    std::vector<std::thread> m_workers ;
+    std::mutex m_mutex ;
+    std::condition_variable m_wake, m_done ;
+    std::function<void(std::size_t)> const * m_job {nullptr} ;
+    std::size_t m_pending {0} ;
+    std::size_t m_generation {0} ;
+    bool m_stop {false} ;
+ } ;
+
+#endif
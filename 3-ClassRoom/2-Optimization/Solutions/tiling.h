@@ -0,0 +1,49 @@
+#ifndef TILING_H
+#define TILING_H
+
+#include <algorithm> // for std::min
+#include <concepts> // for std::integral
+#include <cstddef> // for std::size_t
+#include <iterator> // for std::ranges::next & std::iter_difference_t
+#include <type_traits> // for std::type_identity_t
+
+// end of the tile which starts at begin, for iterators or indices
+template< typename Pos >
+Pos tile_end( Pos begin, Pos end, std::size_t tile )
+ {
+  if constexpr (std::integral<Pos>) return std::min<Pos>(begin+tile,end) ;
+  else return std::ranges::next(begin,static_cast<std::iter_difference_t<Pos>>(tile),end) ;
+ }
+
+// cache blocking : repeat saxpy, that is f(tile_begin,tile_end), on each
+// tile of [begin,end) before moving to the next one, so that the tile
+// stays in cache during the repetitions ; no tiling if tile is 0, and
+// whole() is then repeated instead, for the layouts which have their own
+// saxpy of the whole collection
+template< typename Pos, typename Function, typename Whole >
+void repeat_saxpy
+ ( Pos begin, std::type_identity_t<Pos> end, std::size_t tile, std::size_t repeat,
+   Function f, Whole whole )
+ {
+  if (tile==0)
+   {
+    while (repeat--)
+      whole() ;
+    return ;
+   }
+  while (begin!=end)
+   {
+    Pos next {tile_end(begin,end,tile)} ;
+    for ( std::size_t r=0 ; r<repeat ; ++r )
+      f(begin,next) ;
+    begin = next ;
+   }
+ }
+
+// for the layouts whose saxpy of a range also does the whole collection
+template< typename Pos, typename Function >
+void repeat_saxpy
+ ( Pos begin, std::type_identity_t<Pos> end, std::size_t tile, std::size_t repeat, Function f )
+ { repeat_saxpy(begin,end,tile,repeat,f,[&]{ f(begin,end) ; }) ; }
+
+#endif
@@ -0,0 +1,333 @@
+// Statistical runner for the programs which print lines such as
+// "(title time: 123 us)", replacing the mean of a fixed number of runs
+// given by tmp.time.py :
+// - the first runs are dropped as long as they are much slower than
+//   the following ones (warm-up of the caches, of the frequency...) ;
+// - the outliers are rejected, when their distance to the median
+//   exceeds 3.5 times the MAD scaled as a standard deviation ;
+// - the program is run again until the 95 % confidence interval of
+//   each title is within the requested precision, or max runs ;
+// - the results are given as median and MAD, with the cpu governor
+//   and frequency, which are checked again at the end.
+//
+// usage: time-runner.exe [--min-runs=5] [--max-runs=100] [--precision=0.01]
+//          [--save=file] [--compare=file] [--against="command"]
+//          [--alpha=0.01] [--threshold=0.02] -- command [args...]
+//
+// A/B comparison : with --compare, against samples previously written
+// with --save, or with --against, against another command, run in turn
+// with the first one. Each title is then tested with Mann-Whitney U, and
+// the exit status is 1 if any title of the command is slower than the
+// reference by more than threshold, with a p-value below alpha.
+
+#include "arrays-options.h"
+#include <algorithm> // for std::sort & std::max
+#include <cassert>
+#include <cmath>
+#include <cstdio> // for popen
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+#include <vector>
+#include <format>
+
+using Samples = std::map<std::string,std::vector<double>> ;
+
+//==============================================
+// statistics
+//==============================================
+
+double median( std::vector<double> values )
+ {
+  assert(!values.empty()) ;
+  std::sort(values.begin(),values.end()) ;
+  std::size_t n {values.size()} ;
+  return (n%2)?values[n/2]:(values[n/2-1]+values[n/2])/2 ;
+ }
+
+// median absolute deviation, scaled so to estimate
+// the standard deviation of a normal distribution
+double mad( std::vector<double> const & values )
+ {
+  double med {median(values)} ;
+  std::vector<double> deviations ;
+  for ( double value : values ) deviations.push_back(std::abs(value-med)) ;
+  return 1.4826*median(deviations) ;
+ }
+
+bool is_outlier( double value, double med, double dev )
+ { return (dev>0)&&(std::abs(value-med)>3.5*dev) ; }
+
+std::vector<double> without_outliers( std::vector<double> const & values )
+ {
+  double med {median(values)}, dev {mad(values)} ;
+  std::vector<double> res ;
+  for ( double value : values )
+    if (!is_outlier(value,med,dev)) res.push_back(value) ;
+  return res ;
+ }
+
+// number of leading values which are outliers above the rest,
+// at most half of them
+std::size_t warm_up( std::vector<double> const & values )
+ {
+  std::size_t nb {0} ;
+  while (2*(nb+1)<=values.size())
+   {
+    std::vector<double> rest(values.begin()+nb+1,values.end()) ;
+    double med {median(rest)}, dev {mad(rest)} ;
+    if ((values[nb]<=med)||!is_outlier(values[nb],med,dev)) break ;
+    ++nb ;
+   }
+  return nb ;
+ }
+
+// Student quantile for a two-sided 95 % interval
+double student( std::size_t degrees )
+ {
+  static double const table[] { 12.71, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086 } ;
+  if (degrees==0) return INFINITY ;
+  if (degrees<=20) return table[degrees-1] ;
+  return (degrees<=60)?2.0:1.96 ;
+ }
+
+// half width of the 95 % confidence interval of the mean
+double half_width( std::vector<double> const & values )
+ {
+  std::size_t n {values.size()} ;
+  if (n<2) return INFINITY ;
+  double mean {0.}, variance {0.} ;
+  for ( double value : values ) mean += value ;
+  mean /= n ;
+  for ( double value : values ) variance += (value-mean)*(value-mean) ;
+  variance /= (n-1) ;
+  return student(n-1)*std::sqrt(variance/n) ;
+ }
+
+// two-sided p-value of the Mann-Whitney U test, with the
+// normal approximation and the correction for ties
+double mann_whitney( std::vector<double> const & xs, std::vector<double> const & ys )
+ {
+  std::vector<std::pair<double,int>> all ;
+  for ( double x : xs ) all.emplace_back(x,0) ;
+  for ( double y : ys ) all.emplace_back(y,1) ;
+  std::sort(all.begin(),all.end()) ;
+  double rank_sum {0.}, ties {0.} ;
+  for ( std::size_t i=0 ; i<all.size() ; )
+   {
+    std::size_t j {i} ;
+    while ((j<all.size())&&(all[j].first==all[i].first)) ++j ;
+    double rank {(i+1+j)/2.} ;
+    for ( std::size_t k=i ; k<j ; ++k )
+      if (all[k].second==0) rank_sum += rank ;
+    double t = j-i ;
+    ties += t*t*t-t ;
+    i = j ;
+   }
+  double n1 = xs.size(), n2 = ys.size(), n = n1+n2 ;
+  double u {rank_sum-n1*(n1+1)/2} ;
+  double sigma {std::sqrt(n1*n2/12*((n+1)-ties/(n*(n-1))))} ;
+  if (sigma==0) return 1. ;
+  double z {(std::abs(u-n1*n2/2)-0.5)/sigma} ;
+  return std::erfc(std::max(z,0.)/std::sqrt(2.)) ;
+ }
+
+//==============================================
+// system
+//==============================================
+
+std::string read_line( std::string const & path )
+ {
+  std::ifstream file(path) ;
+  std::string line ;
+  std::getline(file,line) ;
+  return line.empty()?"unknown":line ;
+ }
+
+// governor and current frequency of the first cpu
+struct CpuState
+ {
+  std::string governor ;
+  std::string no_turbo ;
+  double ghz ; // 0 if unknown
+
+  CpuState()
+   {
+    std::string dir {"/sys/devices/system/cpu/cpu0/cpufreq/"} ;
+    governor = read_line(dir+"scaling_governor") ;
+    no_turbo = read_line("/sys/devices/system/cpu/intel_pstate/no_turbo") ;
+    std::string khz {read_line(dir+"scaling_cur_freq")} ;
+    ghz = (khz=="unknown")?0.:std::stod(khz)/1.e6 ;
+   }
+
+  // the frequency is compared within 10 %
+  bool similar( CpuState const & other ) const
+   {
+    return (governor==other.governor)&&(no_turbo==other.no_turbo)&&
+           (std::abs(ghz-other.ghz)<=0.1*std::max(ghz,other.ghz)) ;
+   }
+ } ;
+
+std::ostream & operator<<( std::ostream & os, CpuState const & state )
+ {
+  os<<"governor: "<<state.governor<<", frequency: " ;
+  if (state.ghz>0) os<<std::format("{:.2f} GHz",state.ghz) ;
+  else os<<"unknown" ;
+  return os<<", no_turbo: "<<state.no_turbo ;
+ }
+
+//==============================================
+// runs
+//==============================================
+
+// run the command once, add its times to samples, and
+// return the lines which are not times
+std::vector<std::string> run( std::string const & command, Samples & samples )
+ {
+  static std::regex const expr_time {R"(^\((.*) time: (.*) us\)$)"} ;
+  FILE * pipe {popen((command+" 2>&1").c_str(),"r")} ;
+  if (!pipe) throw std::runtime_error("cannot run: "+command) ;
+  std::vector<std::string> others ;
+  std::string line ;
+  char buffer[4096] ;
+  while (fgets(buffer,sizeof(buffer),pipe))
+   {
+    line += buffer ;
+    if (line.back()!='\n') continue ;
+    line.pop_back() ;
+    std::smatch match ;
+    if (std::regex_match(line,match,expr_time)) samples[match[1]].push_back(std::stod(match[2])) ;
+    else others.push_back(line) ;
+    line.clear() ;
+   }
+  if (!line.empty()) others.push_back(line) ;
+  if (pclose(pipe)!=0) throw std::runtime_error("failed: "+command) ;
+  return others ;
+ }
+
+// the samples kept after the warm-up and the outliers
+Samples clean( Samples const & samples, std::map<std::string,std::size_t> & warm_ups )
+ {
+  Samples res ;
+  for ( auto const & [title,values] : samples )
+   {
+    warm_ups[title] = warm_up(values) ;
+    res[title] = without_outliers({values.begin()+warm_ups[title],values.end()}) ;
+   }
+  return res ;
+ }
+
+bool precise( Samples const & samples, double precision )
+ {
+  std::map<std::string,std::size_t> warm_ups ;
+  for ( auto const & [title,values] : clean(samples,warm_ups) )
+    if (half_width(values)>precision*median(values)) return false ;
+  return true ;
+ }
+
+void report( std::string_view name, Samples const & samples )
+ {
+  std::map<std::string,std::size_t> warm_ups ;
+  for ( auto const & [title,values] : clean(samples,warm_ups) )
+   {
+    std::size_t total {samples.at(title).size()} ;
+    std::cout<<std::format("({}{} median: {:.0f} us, mad: {:.0f} us, 95% ci: +/-{:.2f} %, "
+      "runs: {}, warm-up: {}, outliers: {})\n",name,title,median(values),mad(values),
+      100*half_width(values)/median(values),total,warm_ups[title],total-warm_ups[title]-values.size()) ;
+   }
+ }
+
+void save( std::string const & path, Samples const & samples )
+ {
+  std::ofstream file(path) ;
+  for ( auto const & [title,values] : samples )
+    for ( double value : values ) file<<value<<' '<<title<<'\n' ;
+ }
+
+Samples load( std::string const & path )
+ {
+  std::ifstream file(path) ;
+  if (!file) throw std::runtime_error("cannot read: "+path) ;
+  Samples res ;
+  double value ;
+  std::string title ;
+  while ((file>>value)&&std::getline(file>>std::ws,title)) res[title].push_back(value) ;
+  return res ;
+ }
+
+// compare the samples to the reference ones, and return true
+// if some title is significantly slower
+bool compare( Samples const & reference, Samples const & samples, double alpha, double threshold )
+ {
+  std::map<std::string,std::size_t> warm_ups ;
+  Samples ref {clean(reference,warm_ups)}, cur {clean(samples,warm_ups)} ;
+  bool regression {false} ;
+  for ( auto const & [title,values] : cur )
+   {
+    if (!ref.contains(title)) continue ;
+    double m1 {median(ref[title])}, m2 {median(values)} ;
+    double diff {(m2-m1)/m1} ;
+    double p {mann_whitney(ref[title],values)} ;
+    bool significant {p<alpha} ;
+    if (significant&&(diff>threshold)) regression = true ;
+    std::cout<<std::format("({} A: {:.0f} us, B: {:.0f} us, diff: {:+.2f} %, p: {:.4f}, {})\n",
+      title,m1,m2,100*diff,p,significant?((diff>threshold)?"REGRESSION":"significant"):"not significant") ;
+   }
+  return regression ;
+ }
+
+int main( int argc, char * argv[] )
+ {
+  // options are searched before "--" only
+  int nb_options {1} ;
+  while ((nb_options<argc)&&(std::string_view(argv[nb_options])!="--")) ++nb_options ;
+  assert(nb_options+1<argc) ;
+  std::string command ;
+  for ( int i=nb_options+1 ; i<argc ; ++i ) command += (command.empty()?"":" ")+std::string(argv[i]) ;
+  std::size_t min_runs {std::max(size_option(nb_options,argv,"min-runs",5),std::size_t{2})} ;
+  std::size_t max_runs {std::max(size_option(nb_options,argv,"max-runs",100),min_runs)} ;
+  double precision {std::stod(std::string(option(nb_options,argv,"precision","0.01")))} ;
+  double alpha {std::stod(std::string(option(nb_options,argv,"alpha","0.01")))} ;
+  double threshold {std::stod(std::string(option(nb_options,argv,"threshold","0.02")))} ;
+  std::string against {option(nb_options,argv,"against")} ;
+  std::string save_path {option(nb_options,argv,"save")} ;
+  std::string compare_path {option(nb_options,argv,"compare")} ;
+
+  CpuState state ;
+  std::cout<<"(cpu0 "<<state<<")\n" ;
+
+  // first run, showing the other output lines
+  Samples samples, others ;
+  for ( auto const & line : run(command,samples) ) std::cout<<line<<'\n' ;
+  if (!against.empty()) run(against,others) ;
+
+  // alternate the commands, so that both see the same drift of the machine
+  std::size_t runs {1} ;
+  while ((runs<min_runs)||((runs<max_runs)&&!(precise(samples,precision)&&
+         (against.empty()||precise(others,precision)))))
+   {
+    run(command,samples) ;
+    if (!against.empty()) run(against,others) ;
+    ++runs ;
+   }
+
+  CpuState final_state ;
+  if (!final_state.similar(state)) std::cout<<"(cpu0 has changed, "<<final_state<<")\n" ;
+  report("",samples) ;
+  if (!save_path.empty()) save(save_path,samples) ;
+
+  bool regression {false} ;
+  if (!against.empty())
+   {
+    report("against ",others) ;
+    regression = compare(others,samples,alpha,threshold) ;
+   }
+  if (!compare_path.empty())
+    regression = compare(load(compare_path),samples,alpha,threshold) || regression ;
+  return regression?1:0 ;
+ }
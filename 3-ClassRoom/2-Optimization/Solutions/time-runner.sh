@@ -0,0 +1,35 @@
+#!/usr/bin/env bash
+
+# expected arguments :
+# - which C++ standard to use : 20, 23, ...
+# - which level of optimization : 0, 1, 2, ...
+# - which program to time, which prints "(title time: ... us)" lines
+# - then any option of time-runner : --precision=... --save=... ...
+# - then "--" and the arguments of the program
+
+std=${1}
+shift
+opt=${1}
+shift
+prog=${1}
+shift
+
+options=()
+while [ $# -gt 0 ] && [ "${1}" != "--" ]
+do
+  options+=("${1}")
+  shift
+done
+shift
+
+# compile
+rm -f tmp.time-runner.exe tmp.${prog}.exe
+g++ -std=c++20 -O2 -Wall -Wextra -Wfatal-errors time-runner.cpp -o tmp.time-runner.exe \
+&& g++ -std=c++${std} -O${opt} -march=native -mtune=native -Wall -Wextra -Wfatal-errors ${prog}.cpp -o tmp.${prog}.exe
+if [ $? -ne 0 ]; then
+  echo "COMPILATION ERROR"
+  exit 1
+fi
+
+# run
+./tmp.time-runner.exe "${options[@]}" -- ./tmp.${prog}.exe ${*}
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+
+# Summary of the vectorization reports of gcc, as written by arrays.sh
+# in tmp.<prog>.<opt>.log with -fopt-info-vec-all.
+#
+# usage: vec-report.py tmp.aos-vector.3.log
+#          [--kernels=saxpy,accumulate_y,randomize_x] [--all]
+#        vec-report.py tmp.aos-vector.3.log tmp.soa-vector.3.log
+#
+# For each kernel, that is each function with one of the given names,
+# the loops of the function are listed, with their fate : vectorized,
+# missed (with the reason given by gcc), or partly when the loop has been
+# inlined in several places, and vectorized in some of them only. The log
+# does not name the functions : they are found in the source files, which
+# are searched from the directory of the log, as arrays.sh compiles there.
+#
+# With two logs, such as two levels of optimization, or two layouts of
+# the same kernels, the kernels are compared by their number of vectorized
+# loops, and the exit status is 1 if the second log has fewer.
+# The loops of the system headers are ignored, unless --all is given.
+
+import os, sys
+import re
+
+KERNELS = ['saxpy', 'accumulate_y', 'randomize_x']
+
+KEYWORDS = {'if', 'for', 'while', 'switch', 'return', 'catch', 'sizeof', 'alignof',
+            'decltype', 'static_assert', 'static_cast', 'const_cast', 'reinterpret_cast',
+            'dynamic_cast', 'noexcept', 'requires', 'operator', 'new', 'delete'}
+
+# Utility fonctions
+
+expr_line = re.compile(r"^(.+?):(\d+):(\d+): (optimized|missed|note): (.*)$")
+expr_vectorized = re.compile(r"^loop vectorized using (\d+) byte vectors")
+expr_token = re.compile(r"//[^\n]*|/\*.*?\*/|\"(?:\\.|[^\"\\])*\"|'(?:\\.|[^'\\])*'|::|[A-Za-z_]\w*|\S", re.S)
+expr_ssa = re.compile(r"\b(?:D|SR)\.\d+(?:_\d+)?|_\d+\b|\bbb\d+\b")
+
+def functions(src_file):
+    """(name, first line, last line) of the functions of the file, the
+    name being qualified by the enclosing classes, and the lambdas
+    being part of their enclosing function"""
+    with open(src_file, errors='replace') as src:
+        text = src.read()
+    res = []
+    scopes = []   # [kind, name, depth, first line]
+    depth = 0
+    parens = 0
+    candidate = None   # name followed by (
+    header = None      # name followed by (...), waiting for the body
+    init_list = False  # within a constructor initializer list
+    previous = ''
+    pending_class = None
+    for match in expr_token.finditer(text):
+        token = match.group()
+        if token.startswith('//') or token.startswith('/*') or token[0] in '"\'':
+            continue
+        line = text.count('\n', 0, match.start()) + 1
+        if token in ('class', 'struct', 'union', 'namespace'):
+            pending_class = [token, None]
+        elif pending_class is not None and pending_class[1] is None and re.match(r"[A-Za-z_]", token):
+            pending_class[1] = token
+        elif token == '(':
+            if parens == 0 and not init_list and re.match(r"~?[A-Za-z_]", previous) and previous not in KEYWORDS:
+                candidate = previous
+            parens += 1
+        elif token == ')':
+            parens -= 1
+            if parens == 0 and candidate is not None:
+                header, candidate = candidate, None
+        elif token == ';' and parens == 0:
+            header, init_list, pending_class, candidate = None, False, None, None
+        elif token == ':' and header is not None and parens == 0:
+            init_list = True
+        elif token == '{' and parens == 0:
+            if init_list and re.match(r"[A-Za-z_>]", previous):
+                scopes.append(['init', None, depth, line])
+            elif header is not None and not any(scope[0] == 'function' for scope in scopes):
+                scopes.append(['function', header, depth, line])
+                header, init_list = None, False
+            elif pending_class is not None and pending_class[1] is not None and header is None:
+                scopes.append(['class', pending_class[1], depth, line])
+            else:
+                scopes.append(['block', None, depth, line])
+            pending_class = None
+            depth += 1
+        elif token == '}' and parens == 0:
+            depth -= 1
+            if scopes:
+                kind, name, _, first = scopes.pop()
+                if kind == 'function':
+                    qualified = [scope[1] for scope in scopes if scope[0] == 'class'] + [name]
+                    res.append(('::'.join(qualified), first, line))
+        previous = token
+    return res
+
+def function_of(functions_by_file, src_file, line):
+    """the innermost function of src_file which contains line"""
+    if src_file not in functions_by_file:
+        try:
+            functions_by_file[src_file] = functions(src_file)
+        except OSError:
+            functions_by_file[src_file] = []
+    res = None
+    for name, first, last in functions_by_file[src_file]:
+        if first <= line <= last and (res is None or first >= res[1]):
+            res = (name, first, last)
+    return res[0] if res else '?'
+
+def parse(log_file, show_all):
+    """the loops of the log : {(file, line, col): {'vectorized': set of
+    vector sizes, 'missed': list of reasons, 'contexts': {'vectorized',
+    'missed'}}}"""
+    loops = {}
+    pending = None  # loop which could not be vectorized, waiting for its reason
+    with open(log_file, errors='replace') as log:
+        for text in log:
+            match = expr_line.match(text.rstrip('\n'))
+            if not match:
+                continue
+            src_file, line, col, kind, message = match.groups()
+            if os.path.isabs(src_file) and not show_all:
+                pending = None
+                continue
+            if kind == 'note':
+                continue
+            location = (src_file, int(line), int(col))
+            if kind == 'optimized':
+                vectorized = expr_vectorized.match(message)
+                if vectorized:
+                    loop = loops.setdefault(location, {'vectorized': set(), 'missed': [], 'contexts': set()})
+                    loop['vectorized'].add(int(vectorized.group(1)))
+                    loop['contexts'].add('vectorized')
+                pending = None
+            elif message == "couldn't vectorize loop":
+                loop = loops.setdefault(location, {'vectorized': set(), 'missed': [], 'contexts': set()})
+                loop['contexts'].add('missed')
+                pending = loop
+            elif pending is not None:
+                reason = expr_ssa.sub('_', message.replace('not vectorized: ', ''))
+                if reason not in pending['missed']:
+                    pending['missed'].append(reason)
+                pending = None
+    return loops
+
+def status(loop):
+    if loop['contexts'] == {'vectorized'}:
+        return 'vectorized'
+    if loop['contexts'] == {'missed'}:
+        return 'missed'
+    return 'partly'
+
+def report(log_file, kernels, show_all):
+    """{kernel: [(location, function, loop)]}"""
+    log_dir = os.path.dirname(log_file) or '.'
+    functions_by_file = {}
+    res = {kernel: [] for kernel in kernels}
+    for location, loop in sorted(parse(log_file, show_all).items()):
+        src_file = os.path.join(log_dir, location[0])
+        function = function_of(functions_by_file, src_file, location[1])
+        kernel = function.split('::')[-1]
+        if kernel in res:
+            res[kernel].append((location, function, loop))
+    return res
+
+def count(loops, state):
+    return sum(1 for _, _, loop in loops if status(loop) == state)
+
+def title(log_file):
+    match = re.match(r"^tmp\.(.*)\.(\w+)\.log$", os.path.basename(log_file))
+    return "{} -O{}".format(*match.groups()) if match else log_file
+
+def print_report(log_file, kernels, show_all):
+    print("# {}".format(title(log_file)))
+    for kernel, loops in report(log_file, kernels, show_all).items():
+        if not loops:
+            print("({} : no loop)".format(kernel))
+            continue
+        print("({} : {}/{} loops vectorized)".format(kernel, count(loops, 'vectorized'), len(loops)))
+        for (src_file, line, col), function, loop in loops:
+            where = "{}:{}:{} in {}".format(src_file, line, col, function)
+            sizes = ', '.join(str(size) for size in sorted(loop['vectorized'], reverse=True))
+            if status(loop) == 'vectorized':
+                print("  {} : vectorized ({} byte vectors)".format(where, sizes))
+            elif status(loop) == 'partly':
+                print("  {} : partly vectorized ({} byte vectors), else {}".format(where, sizes, '; '.join(loop['missed'])))
+            else:
+                print("  {} : missed, {}".format(where, '; '.join(loop['missed'])))
+
+def print_diff(log_file1, log_file2, kernels, show_all):
+    report1 = report(log_file1, kernels, show_all)
+    report2 = report(log_file2, kernels, show_all)
+    print("# {} -> {}".format(title(log_file1), title(log_file2)))
+    regressions = 0
+    for kernel in kernels:
+        loops1, loops2 = report1[kernel], report2[kernel]
+        vectorized1, vectorized2 = count(loops1, 'vectorized'), count(loops2, 'vectorized')
+        if vectorized2 < vectorized1:
+            verdict = "REGRESSION"
+            regressions += 1
+        elif vectorized2 > vectorized1:
+            verdict = "improvement"
+        else:
+            verdict = "same"
+        print("({} : {}/{} -> {}/{} loops vectorized, {})".format(
+            kernel, vectorized1, len(loops1), vectorized2, len(loops2), verdict))
+        reasons1 = {reason for _, _, loop in loops1 for reason in loop['missed']}
+        for (src_file, line, col), function, loop in loops2:
+            for reason in loop['missed']:
+                if reason not in reasons1:
+                    print("  new : {}:{}:{} in {} : {}".format(src_file, line, col, function, reason))
+    return regressions
+
+# Arguments
+
+options = {}
+log_files = []
+for arg in sys.argv[1:]:
+    if arg.startswith('--'):
+        name, _, value = arg[2:].partition('=')
+        options[name] = value
+    else:
+        log_files.append(arg)
+if len(log_files) not in (1, 2) or not set(options) <= {'kernels', 'all'}:
+    print("usage: vec-report.py log [other-log] [--kernels=saxpy,...] [--all]", file=sys.stderr)
+    sys.exit(2)
+
+kernels = options['kernels'].split(',') if options.get('kernels') else KERNELS
+show_all = 'all' in options
+
+# Report, or differences
+
+if len(log_files) == 1:
+    print_report(log_files[0], kernels, show_all)
+elif print_diff(log_files[0], log_files[1], kernels, show_all) > 0:
+    sys.exit(1)
@@ -7,25 +7,49 @@
 #include <stdfloat>
 #include <complex>
 
+template< typename R >
+class Complexes ;
+
+// lazy product of two SoA of complex numbers : nothing is computed until
+// assigned, then in one single loop over both the real and imaginary parts,
+// without any temporary array
+template< typename R >
+struct Product
+ { Complexes<R> const & lhs, & rhs ; } ;
+
 // SoA of complex numbers
 template< typename R >
 class Complexes {
   public :  
     Complexes( std::size_t size ) : m_rs(size), m_is(size) {}
+    Complexes( Product<R> const & product ) : Complexes(product.lhs.size())
+     { *this = product ; }
+    // each element only depends on the same index, so the result
+    // may also be one of the operands, as in res = res*cplxs
+    Complexes & operator=( Product<R> const & product )
+     {
+      R const * lrs {std::begin(product.lhs.m_rs)}, * lis {std::begin(product.lhs.m_is)} ;
+      R const * rrs {std::begin(product.rhs.m_rs)}, * ris {std::begin(product.rhs.m_is)} ;
+      for ( std::size_t i = 0 ; i < size() ; ++i )
+       {
+        R lr {lrs[i]}, li {lis[i]}, rr {rrs[i]}, ri {ris[i]} ;
+        m_rs[i] = lr*rr - li*ri ;
+        m_is[i] = rr*li + lr*ri ;
+       }
+      return *this ;
+     }
     std::complex<R> operator[]( int indice ) const
      { return { m_rs[indice], m_is[indice] } ; }
     std::valarray<R> & reals() { return m_rs ; }
     std::valarray<R> & imags() { return m_is ; }
-    std::size_t size() { return m_rs.size() ; }
+    std::size_t size() const { return m_rs.size() ; }
   private :
     std::valarray<R> m_rs, m_is ;
  } ;
 
-Complexes<R> operator*( Complexes<R> const & lhs, Complexes<R> const & rhs ) {
-  Complexes<R> res {lhs.size()} ;
-  res.reals() = lhs.reals()*rhs.reals() - lhs.imags()*rhs.imags() ;
-  res.imags() = rhs.reals()*lhs.imags() + lhs.reals()*rhs.imags() ;
-  return res ;
+template< typename R >
+Product<R> operator*( Complexes<R> const & lhs, Complexes<R> const & rhs ) {
+  return { lhs, rhs } ;
 }
 
 template< typename R>
@@ -42,12 +66,16 @@ Complexes<R> random( std::size_t size )
   return cplxs ;
  }
 
+// exponentiation by squaring : O(log(degree)) products instead of degree,
+// so the rounding errors also accumulate in log(degree) steps
 template< typename R>
 Complexes<R> pow( Complexes<R> & cplxs, long long degree )
  {
   Complexes<R> res {cplxs} ;
-  for ( long long d = 1 ; d < degree ; ++d ) {
-    res = res*cplxs ;
+  Complexes<R> square {cplxs} ;
+  for ( long long d = degree-1 ; d > 0 ; d /= 2 ) {
+    if (d%2) res = res*square ;
+    if (d>1) square = square*square ;
   }
   return res ;
  }
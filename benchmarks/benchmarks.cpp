@@ -0,0 +1,483 @@
+// Google Benchmark suite for the kernels of the course : one executable
+// which registers each kernel for a sweep of sizes and for several
+// floating point types, so that its results can be kept and compared
+// from one version of the code to the next.
+//
+// usage: benchmarks.exe [--benchmark_filter=saxpy/.*/float]
+//          [--benchmark_repetitions=10] [--benchmark_format=json]
+//          [--benchmark_out=file.json] ...
+//
+// The benchmarks are named kernel/variant/type/size..., such as
+// saxpy/soa-aligned/double/4096 or analyse/1/float/65536/64.
+//
+// Within the timed loops :
+// - benchmark::DoNotOptimize(value) forces the value to be computed, and
+//   makes the compiler forget what it knows about it, so that a constant
+//   such as the factor of saxpy is not folded from one iteration to the next ;
+// - benchmark::ClobberMemory() forces the kernels which only write into
+//   memory to really do it at each iteration, provided the containers have
+//   first escaped with DoNotOptimize(container).
+//
+// Only the kernels which live in a header of the course are included, such
+// as soa-aligned.h, aosoa.h or power.h. The others are defined next to the
+// main of their program, and for double only : XY and SoA of the arrays,
+// analyse1 & analyse2 of chrono.1.cpp, multiply, divide & reduce of the
+// operations, and SiUnit of emc2.cpp are therefore copied below, as
+// templates on the floating point type. Each section names the program it
+// comes from : a change of the original must be reported here by hand.
+
+#include "../3-ClassRoom/2-Optimization/Solutions/soa-aligned.h"
+#include "../3-ClassRoom/2-Optimization/Solutions/aosoa.h"
+#include "../2-ClassRoom/4-ConcurrentProgramming/Solutions/power.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <complex>
+#include <cstdlib> // for rand
+#include <iterator> // for std::begin & std::end
+#include <list>
+#include <numbers>
+#include <string>
+#include <type_traits>
+#include <valarray>
+#include <vector>
+
+//==============================================
+// utilities
+//==============================================
+
+template< typename Real >
+constexpr char const * type_name()
+ {
+  if constexpr (std::is_same_v<Real,float>) return "float" ;
+  else if constexpr (std::is_same_v<Real,double>) return "double" ;
+  else return "long-double" ;
+ }
+
+// from the L1 cache up to the main memory
+benchmark::internal::Benchmark * sizes( benchmark::internal::Benchmark * bench )
+ { return bench->RangeMultiplier(8)->Range(1<<8,1<<20) ; }
+
+// elements per second, and bytes per second, for the
+// given number of bytes read or written per element
+void set_throughput( benchmark::State & state, std::size_t size, std::size_t bytes )
+ {
+  state.SetItemsProcessed(state.iterations()*size) ;
+  state.SetBytesProcessed(state.iterations()*size*bytes) ;
+ }
+
+template< typename Real >
+Real random_real()
+ { return static_cast<Real>(std::rand()/(RAND_MAX+1.)-0.5) ; }
+
+//==============================================
+// saxpy, for each layout (2-Optimization/arrays)
+// and each precision (3-FloatingPointComputing)
+//==============================================
+
+template< typename Real >
+struct XY
+ {
+  Real x, y {0} ;
+  void saxpy( Real a )
+   { y = a*x + y ; }
+ } ;
+
+template< typename Itr >
+void randomize_x( Itr begin, Itr end )
+ {
+  srand(1) ;
+  for ( ; begin!=end ; ++begin )
+   { begin->x = std::rand()/(RAND_MAX+1.)-0.5 ; }
+ }
+
+template< typename Itr, typename Real >
+void saxpy( Itr begin, Itr end, Real a )
+ {
+  for ( ; begin!=end ; ++begin )
+   { begin->saxpy(a) ; }
+ }
+
+template< typename Container >
+class SoA
+ {
+  public :
+    using Real = typename Container::value_type ;
+    SoA( std::size_t size ) : m_xs(size), m_ys(size) {}
+    void randomize_x()
+     {
+      srand(1) ;
+      for ( Real & x : m_xs ) x = random_real<Real>() ;
+     }
+    void saxpy( Real a )
+     {
+      auto ys {std::begin(m_ys)} ;
+      for ( Real x : m_xs ) { *ys = a*x + *ys ; ++ys ; }
+     }
+  private :
+    Container m_xs ;
+    Container m_ys ;
+ } ;
+
+template< typename Real >
+class AlignedXY
+ {
+  public :
+    AlignedXY( std::size_t size ) : m_soa(size) {}
+    void randomize_x()
+     {
+      srand(1) ;
+      Real * xs {m_soa.template data<&XY<Real>::x>()} ;
+      for ( std::size_t i=0 ; i<m_soa.size() ; ++i )
+       { xs[i] = random_real<Real>() ; }
+     }
+    void saxpy( Real a )
+     {
+      Real const * __restrict__ xs {m_soa.template data<&XY<Real>::x>()} ;
+      Real * __restrict__ ys {m_soa.template data<&XY<Real>::y>()} ;
+      for ( std::size_t i=0 ; i<m_soa.padded_size() ; ++i )
+        ys[i] = a*xs[i] + ys[i] ;
+     }
+  private :
+    AlignedSoA<XY<Real>,&XY<Real>::x,&XY<Real>::y> m_soa ;
+ } ;
+
+template< typename Container, typename Real >
+void saxpy_aos( benchmark::State & state )
+ {
+  std::size_t size = state.range(0) ;
+  Container collection(size) ;
+  randomize_x(std::begin(collection),std::end(collection)) ;
+  benchmark::DoNotOptimize(collection) ;
+  Real a {0.1} ;
+  for ( auto _ : state )
+   {
+    benchmark::DoNotOptimize(a) ;
+    saxpy(std::begin(collection),std::end(collection),a) ;
+    benchmark::ClobberMemory() ;
+   }
+  set_throughput(state,size,3*sizeof(Real)) ;
+ }
+
+template< typename Collection, typename Real >
+void saxpy_soa( benchmark::State & state )
+ {
+  std::size_t size = state.range(0) ;
+  Collection collection(size) ;
+  collection.randomize_x() ;
+  benchmark::DoNotOptimize(collection) ;
+  Real a {0.1} ;
+  for ( auto _ : state )
+   {
+    benchmark::DoNotOptimize(a) ;
+    collection.saxpy(a) ;
+    benchmark::ClobberMemory() ;
+   }
+  set_throughput(state,size,3*sizeof(Real)) ;
+ }
+
+template< typename Real >
+void register_saxpy()
+ {
+  std::string type {type_name<Real>()} ;
+  sizes(benchmark::RegisterBenchmark(("saxpy/aos-vector/"+type).c_str(),saxpy_aos<std::vector<XY<Real>>,Real>)) ;
+  sizes(benchmark::RegisterBenchmark(("saxpy/aos-list/"+type).c_str(),saxpy_aos<std::list<XY<Real>>,Real>)) ;
+  if constexpr (std::is_same_v<Real,double>)
+    sizes(benchmark::RegisterBenchmark(("saxpy/aosoa-vector/"+type).c_str(),saxpy_aos<AoSoA<8>,Real>)) ;
+  sizes(benchmark::RegisterBenchmark(("saxpy/soa-vector/"+type).c_str(),saxpy_soa<SoA<std::vector<Real>>,Real>)) ;
+  sizes(benchmark::RegisterBenchmark(("saxpy/soa-valarray/"+type).c_str(),saxpy_soa<SoA<std::valarray<Real>>,Real>)) ;
+  sizes(benchmark::RegisterBenchmark(("saxpy/soa-aligned/"+type).c_str(),saxpy_soa<AlignedXY<Real>,Real>)) ;
+ }
+
+//==============================================
+// analyse1 & analyse2 (1-Profiling/chrono)
+//==============================================
+
+template< typename Real >
+std::valarray<Real> generate( std::size_t size )
+ {
+  srand(1) ;
+  std::valarray<Real> data(size) ;
+  for ( Real & value : data )
+   { value = static_cast<Real>(std::rand()/(RAND_MAX+1.)) ; }
+  return data ;
+ }
+
+template< typename Real >
+Real analyse1( std::valarray<Real> const & data, int power )
+ {
+  Real res = 0 ;
+  for ( Real value : data ) {
+    Real prod = 1 ;
+    for ( int j=0 ; j<power ; ++j ) {
+      prod *= value ;
+    }
+    res += prod ;
+   }
+  return res ;
+ }
+
+template< typename Real >
+Real analyse2( std::valarray<Real> const & data, int power )
+ {
+  std::valarray<Real> values(1.,data.size()) ;
+  for ( int j=0 ; j<power ; ++j ) {
+    values *= data ;
+  }
+  Real res = 0 ;
+  for ( Real value : values ) {
+    res += value ;
+  }
+  return res ;
+ }
+
+template< typename Real, Real (*analyse)( std::valarray<Real> const &, int ) >
+void analyse_bench( benchmark::State & state )
+ {
+  std::size_t size = state.range(0) ;
+  int power = state.range(1) ;
+  auto data {generate<Real>(size)} ;
+  for ( auto _ : state )
+   {
+    benchmark::DoNotOptimize(power) ;
+    benchmark::DoNotOptimize(analyse(data,power)) ;
+   }
+  set_throughput(state,size,sizeof(Real)) ;
+ }
+
+template< typename Real >
+void register_analyse()
+ {
+  std::string type {type_name<Real>()} ;
+  benchmark::RegisterBenchmark(("analyse/1/"+type).c_str(),analyse_bench<Real,analyse1<Real>>)
+    ->ArgsProduct({benchmark::CreateRange(1<<8,1<<20,8),{4,64}}) ;
+  benchmark::RegisterBenchmark(("analyse/2/"+type).c_str(),analyse_bench<Real,analyse2<Real>>)
+    ->ArgsProduct({benchmark::CreateRange(1<<8,1<<20,8),{4,64}}) ;
+ }
+
+//==============================================
+// multiply, divide & reduce (2-Optimization/operations)
+//==============================================
+
+template< typename Real >
+std::vector<Real> randomize( std::size_t size )
+ {
+  srand(1) ;
+  std::vector<Real> x(size) ;
+  for ( Real & value : x ) value = random_real<Real>() ;
+  return x ;
+ }
+
+template< typename Real >
+void multiply( std::vector<Real> const & x, std::vector<Real> & y )
+ {
+  for ( std::size_t i=0 ; i<x.size() ; ++i )
+    y[i] += x[i]*Real(.1) ;
+ }
+
+template< typename Real >
+void divide( std::vector<Real> const & x, std::vector<Real> & y )
+ {
+  for ( std::size_t i=0 ; i<x.size() ; ++i )
+    y[i] += x[i]/Real(10.) ;
+ }
+
+template< typename Real >
+Real reduce( std::vector<Real> const & y )
+ {
+  Real res {0.} ;
+  for ( Real value : y )
+    res += value ;
+  return res ;
+ }
+
+template< typename Real, void (*operation)( std::vector<Real> const &, std::vector<Real> & ) >
+void operation_bench( benchmark::State & state )
+ {
+  std::size_t size = state.range(0) ;
+  auto x {randomize<Real>(size)} ;
+  std::vector<Real> y(size) ;
+  benchmark::DoNotOptimize(y.data()) ;
+  for ( auto _ : state )
+   {
+    operation(x,y) ;
+    benchmark::ClobberMemory() ;
+   }
+  set_throughput(state,size,3*sizeof(Real)) ;
+ }
+
+template< typename Real >
+void reduce_bench( benchmark::State & state )
+ {
+  std::size_t size = state.range(0) ;
+  auto y {randomize<Real>(size)} ;
+  for ( auto _ : state )
+    benchmark::DoNotOptimize(reduce(y)) ;
+  set_throughput(state,size,sizeof(Real)) ;
+ }
+
+template< typename Real >
+void register_operations()
+ {
+  std::string type {type_name<Real>()} ;
+  sizes(benchmark::RegisterBenchmark(("operations/multiply/"+type).c_str(),operation_bench<Real,multiply<Real>>)) ;
+  sizes(benchmark::RegisterBenchmark(("operations/divide/"+type).c_str(),operation_bench<Real,divide<Real>>)) ;
+  sizes(benchmark::RegisterBenchmark(("operations/reduce/"+type).c_str(),reduce_bench<Real>)) ;
+ }
+
+//==============================================
+// complexes_pow (4-ConcurrentProgramming/power)
+//==============================================
+
+template< typename Real >
+std::vector<std::complex<Real>> unit_complexes( std::size_t size )
+ {
+  srand(1) ;
+  std::vector<std::complex<Real>> cs(size) ;
+  for ( auto & c : cs ) c = std::polar(Real(1),static_cast<Real>(2*std::numbers::pi*std::rand()/(RAND_MAX+1.))) ;
+  return cs ;
+ }
+
+template< typename Real, bool polar >
+void complexes_pow( benchmark::State & state )
+ {
+  std::size_t size = state.range(0) ;
+  int degree = state.range(1) ;
+  auto xs {unit_complexes<Real>(size)} ;
+  std::vector<std::complex<Real>> ys(size) ;
+  benchmark::DoNotOptimize(ys.data()) ;
+  for ( auto _ : state )
+   {
+    benchmark::DoNotOptimize(degree) ;
+    if constexpr (polar) power::polar(size,xs.data(),degree,ys.data(),true) ;
+    else power::squaring(size,xs.data(),degree,ys.data()) ;
+    benchmark::ClobberMemory() ;
+   }
+  set_throughput(state,size,2*sizeof(std::complex<Real>)) ;
+ }
+
+template< typename Real >
+void register_complexes_pow()
+ {
+  std::string type {type_name<Real>()} ;
+  benchmark::RegisterBenchmark(("complexes_pow/squaring/"+type).c_str(),complexes_pow<Real,false>)
+    ->ArgsProduct({benchmark::CreateRange(1<<8,1<<20,8),{10,1000}}) ;
+  benchmark::RegisterBenchmark(("complexes_pow/polar/"+type).c_str(),complexes_pow<Real,true>)
+    ->ArgsProduct({benchmark::CreateRange(1<<8,1<<20,8),{10,1000}}) ;
+ }
+
+//==============================================
+// units (4-QuantitiesAndUnits/emc2)
+//==============================================
+
+// the SiUnit of emc2.cpp, for scalars only
+
+template< typename UnderlyingType, int s, int m, int kg >
+class SiUnit {
+  public :
+    SiUnit() = default ;
+    explicit SiUnit( UnderlyingType value ) : my_value{value} {}
+    explicit operator UnderlyingType() const { return my_value ; }
+  private :
+    UnderlyingType my_value {} ;
+} ;
+
+template< typename UT, int s, int m, int kg >
+auto operator+( SiUnit<UT,s,m,kg> lhs, SiUnit<UT,s,m,kg> rhs )
+ { return SiUnit<UT,s,m,kg>(static_cast<UT>(lhs)+static_cast<UT>(rhs)) ; }
+
+template< typename UT, int s1, int m1, int kg1, int s2, int m2, int kg2 >
+auto operator*( SiUnit<UT,s1,m1,kg1> lhs, SiUnit<UT,s2,m2,kg2> rhs )
+ { return SiUnit<UT,s1+s2,m1+m2,kg1+kg2>(static_cast<UT>(lhs)*static_cast<UT>(rhs)) ; }
+
+template< typename UT, int s, int m, int kg >
+auto square( SiUnit<UT,s,m,kg> value )
+ { return value*value ; }
+
+template< typename UT, int s, int m, int kg >
+auto sqrt( SiUnit<UT,s,m,kg> value )
+ { return SiUnit<UT,s/2,m/2,kg/2>(std::sqrt(static_cast<UT>(value))) ; }
+
+template< typename Real > using Mass = SiUnit<Real,0,0,1> ;
+template< typename Real > using Speed = SiUnit<Real,-1,1,0> ;
+template< typename Real > using Momentum = SiUnit<Real,-1,1,1> ;
+template< typename Real > using Energy = SiUnit<Real,-2,2,1> ;
+
+// e = sqrt(m^2c^4+p^2c^2), with units or with raw numbers : the
+// units are checked at compile time, and should cost nothing at run time
+template< typename Real >
+void energies( std::vector<Mass<Real>> const & ms, std::vector<Momentum<Real>> const & ps, Speed<Real> c, std::vector<Energy<Real>> & es )
+ {
+  for ( std::size_t i=0 ; i<ms.size() ; ++i )
+    es[i] = sqrt(square(ms[i])*square(square(c))+square(ps[i])*square(c)) ;
+ }
+
+template< typename Real >
+void energies( std::vector<Real> const & ms, std::vector<Real> const & ps, Real c, std::vector<Real> & es )
+ {
+  for ( std::size_t i=0 ; i<ms.size() ; ++i )
+    es[i] = std::sqrt(ms[i]*ms[i]*c*c*c*c+ps[i]*ps[i]*c*c) ;
+ }
+
+template< typename Real, bool units >
+void energies_bench( benchmark::State & state )
+ {
+  std::size_t size = state.range(0) ;
+  using M = std::conditional_t<units,Mass<Real>,Real> ;
+  using P = std::conditional_t<units,Momentum<Real>,Real> ;
+  using C = std::conditional_t<units,Speed<Real>,Real> ;
+  using E = std::conditional_t<units,Energy<Real>,Real> ;
+  srand(1) ;
+  std::vector<M> ms(size) ;
+  std::vector<P> ps(size) ;
+  for ( std::size_t i=0 ; i<size ; ++i )
+   {
+    ms[i] = M(std::abs(random_real<Real>())) ;
+    ps[i] = P(random_real<Real>()) ;
+   }
+  std::vector<E> es(size) ;
+  benchmark::DoNotOptimize(es.data()) ;
+  C c {Real(2.99792458)} ;
+  for ( auto _ : state )
+   {
+    benchmark::DoNotOptimize(c) ;
+    energies(ms,ps,c,es) ;
+    benchmark::ClobberMemory() ;
+   }
+  set_throughput(state,size,3*sizeof(Real)) ;
+ }
+
+template< typename Real >
+void register_units()
+ {
+  std::string type {type_name<Real>()} ;
+  sizes(benchmark::RegisterBenchmark(("units/raw/"+type).c_str(),energies_bench<Real,false>)) ;
+  sizes(benchmark::RegisterBenchmark(("units/si/"+type).c_str(),energies_bench<Real,true>)) ;
+ }
+
+//==============================================
+// main
+//==============================================
+
+void register_all()
+ {
+  register_saxpy<float>() ;
+  register_saxpy<double>() ;
+  register_saxpy<long double>() ;
+  register_analyse<float>() ;
+  register_analyse<double>() ;
+  register_operations<float>() ;
+  register_operations<double>() ;
+  register_complexes_pow<float>() ;
+  register_complexes_pow<double>() ;
+  register_units<float>() ;
+  register_units<double>() ;
+ }
+
+int main( int argc, char * argv[] )
+ {
+  benchmark::Initialize(&argc,argv) ;
+  if (benchmark::ReportUnrecognizedArguments(argc,argv)) return 1 ;
+  register_all() ;
+  benchmark::RunSpecifiedBenchmarks() ;
+  benchmark::Shutdown() ;
+ }
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+
+# expected arguments :
+# - which C++ standard to use : 20, 23, ...
+# - which level of optimization : 0, 1, 2, ...
+# - then any option of Google Benchmark : --benchmark_filter=saxpy ...
+
+std=${1}
+shift
+opt=${1}
+shift
+
+# compile
+rm -f tmp.benchmarks.exe
+g++ -std=c++${std} -O${opt} -march=native -mtune=native -funroll-loops -Wall -Wextra -Wfatal-errors benchmarks.cpp -o tmp.benchmarks.exe -lbenchmark -lpthread
+if [ $? -ne 0 ]; then
+  echo "COMPILATION ERROR"
+  exit 1
+fi
+
+# run
+./tmp.benchmarks.exe ${*}